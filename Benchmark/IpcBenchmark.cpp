@@ -0,0 +1,175 @@
+#include "BleEmulator.h"
+#include "InputClient.h"
+#include "LoopbackReportSink.h"
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Throughput and latency of the local IPC front-end: a forked producer
+// process feeds an emulator daemon, with the loopback transport behind it,
+// through the shared-memory ring and through batches on the control socket.
+//
+// Prints one "name=value" line per metric. An optional argument scales the
+// event counts, e.g. 0.1 for a quick smoke run.
+
+namespace
+{
+    const char* const m_phases[] = { "ring_paced", "ring", "socket_batch" };
+    constexpr size_t m_batchSize = 256;
+    constexpr auto m_pacedInterval = std::chrono::microseconds(250);
+
+    InputEvent EventAt(size_t i)
+    {
+        switch (i % 4)
+        {
+        case 0: return InputEvent::KeyPress(0x1E);
+        case 1: return InputEvent::KeyRelease(0x1E);
+        case 2: return InputEvent::MouseMove(3, -2, 0);
+        default: return InputEvent::MouseMove(-1, 4, 0);
+        }
+    }
+
+    void Signal(int fd)
+    {
+        char token = 1;
+        if (write(fd, &token, 1) != 1)
+            std::_Exit(1);
+    }
+
+    void WaitFor(int fd)
+    {
+        char token;
+        if (read(fd, &token, 1) != 1)
+            std::_Exit(1);
+    }
+
+    // Runs in the child; the daemon may still be starting up.
+    void RunProducer(const std::string& name, size_t pacedEvents, size_t events, int toParent, int fromParent)
+    {
+        InputClient client;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (!client.Connect(name))
+        {
+            if (std::chrono::steady_clock::now() > deadline)
+            {
+                std::fprintf(stderr, "cannot connect to '%s'\n", name.c_str());
+                std::_Exit(1);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+
+        for (const char* phase : m_phases)
+        {
+            std::string current = phase;
+            size_t count = current == "ring_paced" ? pacedEvents : events;
+            auto start = std::chrono::steady_clock::now();
+
+            if (current == "ring_paced")
+            {
+                // Spaced out so nothing queues up: isolates the transfer cost.
+                auto next = start;
+                for (size_t i = 0; i < count; ++i)
+                {
+                    while (std::chrono::steady_clock::now() < next)
+                        std::this_thread::yield();
+                    client.Send(EventAt(i));
+                    next += m_pacedInterval;
+                }
+            }
+            else if (current == "ring")
+            {
+                for (size_t i = 0; i < count; ++i)
+                    client.Send(EventAt(i));
+            }
+            else
+            {
+                std::vector<InputEvent> batch(m_batchSize);
+                for (size_t sent = 0; sent < count; sent += m_batchSize)
+                {
+                    for (size_t i = 0; i < m_batchSize; ++i)
+                        batch[i] = EventAt(sent + i);
+                    client.SendBatch(batch.data(), batch.size());
+                }
+            }
+            client.Flush();
+
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            std::printf("%s.events=%zu\n", phase, count);
+            std::printf("%s.events_per_sec=%.0f\n", phase, seconds > 0.0 ? static_cast<double>(count) / seconds : 0.0);
+            std::fflush(stdout);
+            Signal(toParent);
+            WaitFor(fromParent);
+        }
+    }
+
+    void PrintSummary(const char* phase, const char* name, const LatencySummary& summary)
+    {
+        std::printf("%s.%s_p50_ns=%lld\n", phase, name, static_cast<long long>(summary.p50.count()));
+        std::printf("%s.%s_p99_ns=%lld\n", phase, name, static_cast<long long>(summary.p99.count()));
+        std::printf("%s.%s_max_ns=%lld\n", phase, name, static_cast<long long>(summary.max.count()));
+    }
+}
+
+int main(int argc, char** argv)
+{
+    double scale = argc > 1 ? std::max(std::atof(argv[1]), 0.0001) : 1.0;
+    size_t pacedEvents = std::max<size_t>(4, static_cast<size_t>(4000 * scale)) / 4 * 4;
+    size_t events = std::max<size_t>(m_batchSize, static_cast<size_t>(400000 * scale)) / m_batchSize * m_batchSize;
+    std::string name = "bench-" + std::to_string(getpid());
+
+    // Fork before any thread exists; the child only ever talks to the daemon.
+    int toParent[2];
+    int toChild[2];
+    if (pipe(toParent) != 0 || pipe(toChild) != 0)
+        return 1;
+    pid_t producer = fork();
+    if (producer < 0)
+        return 1;
+    if (producer == 0)
+    {
+        RunProducer(name, pacedEvents, events, toParent[1], toChild[0]);
+        std::_Exit(0);
+    }
+
+    LoopbackReportSink sink;
+    BleEmulator emulator(&sink);
+    emulator.Initialize();
+    // Connection events as tight as the scheduler allows, so the link is not the limit.
+    emulator.SetConnectionInterval(std::chrono::microseconds(1));
+    if (!emulator.StartInputServer(name))
+    {
+        std::fprintf(stderr, "cannot start the input server\n");
+        kill(producer, SIGKILL);
+        return 1;
+    }
+
+    for (const char* phase : m_phases)
+    {
+        WaitFor(toParent[0]);
+        auto server = emulator.GetInputServerStats();
+        auto stats = emulator.GetStats();
+        PrintSummary(phase, "transfer", server.transferLatency);
+        PrintSummary(phase, "keyboard_end_to_end", stats.reportLatency[static_cast<size_t>(HidReportId::Keyboard)].endToEnd);
+        PrintSummary(phase, "mouse_end_to_end", stats.reportLatency[static_cast<size_t>(HidReportId::Mouse)].endToEnd);
+        std::fflush(stdout);
+        emulator.ResetStats();
+        Signal(toChild[1]);
+    }
+
+    int status = 0;
+    waitpid(producer, &status, 0);
+    auto server = emulator.GetInputServerStats();
+    std::printf("server.ring_events=%llu\n", static_cast<unsigned long long>(server.ringEvents));
+    std::printf("server.socket_events=%llu\n", static_cast<unsigned long long>(server.socketEvents));
+    std::printf("server.rejected_events=%llu\n", static_cast<unsigned long long>(server.rejectedEvents));
+    std::printf("server.lossy_batches=%llu\n", static_cast<unsigned long long>(server.lossyBatches));
+    std::printf("loopback.reports=%llu\n", static_cast<unsigned long long>(sink.GetTotalReportCount()));
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0 ? 0 : 1;
+}
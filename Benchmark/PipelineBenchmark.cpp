@@ -0,0 +1,505 @@
+#include "BleEmulator.h"
+#include "HidHelper.h"
+#include "HidReportMonitor.h"
+#include "InputQueue.h"
+#include "KeyboardReportEngine.h"
+#include "LoopbackReportSink.h"
+#include "MouseMotionCoalescer.h"
+#include "MouseReportEngine.h"
+#include "PeerDirectory.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Microbenchmarks for the input pipeline, from scan code translation up to
+// events per second through BleEmulator into a loopback transport.
+//
+// Prints one "name=value" line per metric. An optional argument scales the
+// iteration counts, e.g. 0.1 for a quick smoke run.
+
+namespace
+{
+    // Accepts everything and only counts, so the engines are measured alone.
+    class CountingSink : public HidReportSink
+    {
+    public:
+        bool IsReady(HidReportId) const override { return true; }
+        void SendReport(HidReportId, const uint8_t* data, size_t size) override
+        {
+            m_reports++;
+            m_checksum += size != 0 ? data[size - 1] : 0;
+        }
+
+        uint64_t m_reports = 0;
+        uint64_t m_checksum = 0;
+    };
+
+    double g_scale = 1.0;
+
+    size_t Iterations(size_t base)
+    {
+        return std::max<size_t>(1, static_cast<size_t>(static_cast<double>(base) * g_scale));
+    }
+
+    template <typename Body>
+    double NanosecondsPerOp(size_t operations, Body body)
+    {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        return elapsed / static_cast<double>(operations);
+    }
+
+    void Report(const char* name, double nsPerOp)
+    {
+        std::printf("%s.ns_per_op=%.3f\n", name, nsPerOp);
+        std::printf("%s.ops_per_sec=%.0f\n", name, nsPerOp > 0.0 ? 1e9 / nsPerOp : 0.0);
+    }
+
+    std::vector<uint32_t> KnownScanCodes()
+    {
+        std::vector<uint32_t> scanCodes;
+        for (uint32_t usage = 0; usage < 256; ++usage)
+        {
+            uint32_t scanCode = HidHelper::GetPs2Set1FromHidUsage(static_cast<uint8_t>(usage));
+            if (scanCode != 0)
+                scanCodes.push_back(scanCode);
+        }
+        return scanCodes;
+    }
+
+    void BenchmarkScanCodes(const std::vector<uint32_t>& scanCodes)
+    {
+        size_t rounds = Iterations(100000);
+        volatile uint32_t checksum = 0;
+        Report("scan_code_lookup", NanosecondsPerOp(rounds * scanCodes.size(), [&] {
+            for (size_t round = 0; round < rounds; ++round)
+            {
+                uint32_t sum = 0;
+                for (auto scanCode : scanCodes)
+                    sum += HidHelper::GetHidUsageFromPs2Set1(scanCode);
+                checksum = checksum + sum;
+            }
+        }));
+
+        std::vector<uint8_t> usages(scanCodes.size());
+        Report("scan_code_bulk", NanosecondsPerOp(rounds * scanCodes.size(), [&] {
+            for (size_t round = 0; round < rounds; ++round)
+                HidHelper::GetHidUsagesFromPs2Set1(scanCodes.data(), scanCodes.size(), usages.data());
+        }));
+    }
+
+    void BenchmarkKeyboardReports(const std::vector<uint32_t>& scanCodes)
+    {
+        CountingSink sink;
+        KeyboardReportEngine keyboard(sink);
+        size_t rounds = Iterations(20000);
+
+        // Press and release every key once per round: one report per call.
+        Report("keyboard_report", NanosecondsPerOp(rounds * scanCodes.size() * 2, [&] {
+            for (size_t round = 0; round < rounds; ++round)
+            {
+                for (auto scanCode : scanCodes)
+                {
+                    keyboard.PressKey(scanCode);
+                    keyboard.ReleaseKey(scanCode);
+                }
+            }
+        }));
+
+        // Six keys held at once, the full 6KRO slot set, then released in reverse.
+        const uint32_t chord[] = { 0x1E, 0x1F, 0x20, 0x21, 0x22, 0x23 };
+        Report("keyboard_chord_report", NanosecondsPerOp(rounds * 12, [&] {
+            for (size_t round = 0; round < rounds; ++round)
+            {
+                for (auto scanCode : chord)
+                    keyboard.PressKey(scanCode);
+                for (size_t i = 6; i-- > 0;)
+                    keyboard.ReleaseKey(chord[i]);
+            }
+        }));
+        std::printf("keyboard_report.reports=%llu\n", static_cast<unsigned long long>(sink.m_reports));
+
+        // F5-F10 resolve to consumer usages through the key action table.
+        const uint32_t mediaKeys[] = { 0x3F, 0x40, 0x41, 0x42, 0x43, 0x44 };
+        Report("keyboard_action_lookup", NanosecondsPerOp(rounds * 12, [&] {
+            for (size_t round = 0; round < rounds; ++round)
+            {
+                for (auto scanCode : mediaKeys)
+                {
+                    keyboard.PressKey(scanCode);
+                    keyboard.ReleaseKey(scanCode);
+                }
+            }
+        }));
+
+        // A table swapped in before every key press, to price the handover.
+        KeyActionTable actions = KeyActionTable::Default();
+        size_t swaps = Iterations(20000);
+        Report("keyboard_action_swap", NanosecondsPerOp(swaps, [&] {
+            for (size_t i = 0; i < swaps; ++i)
+            {
+                keyboard.SetKeyActions(actions);
+                keyboard.PressKey(0x3F);
+                keyboard.ReleaseKey(0x3F);
+            }
+        }));
+    }
+
+    void BenchmarkMouseReports()
+    {
+        CountingSink sink;
+        MouseReportEngine mouse(sink);
+        size_t moves = Iterations(2000000);
+
+        Report("mouse_report", NanosecondsPerOp(moves, [&] {
+            for (size_t i = 0; i < moves; ++i)
+                mouse.Move(static_cast<int>(i % 7) - 3, static_cast<int>(i % 5) - 2);
+        }));
+
+        // Many small deltas merged per report, as the sender thread does under load.
+        constexpr size_t movesPerFlush = 16;
+        Report("mouse_coalesced_move", NanosecondsPerOp(moves, [&] {
+            for (size_t i = 0; i < moves; ++i)
+            {
+                mouse.AddMotion(static_cast<int>(i % 7) - 3, 2);
+                if (i % movesPerFlush == movesPerFlush - 1)
+                    mouse.FlushMotion();
+            }
+            mouse.FlushMotion();
+        }));
+
+        // Deltas far beyond the 8-bit report range, split into steps.
+        MouseMotionCoalescer coalescer;
+        size_t steps = 0;
+        int16_t dx, dy, wheel, pan;
+        Report("mouse_split_step", NanosecondsPerOp(Iterations(200000) * 8, [&] {
+            for (size_t i = 0; i < Iterations(200000); ++i)
+            {
+                coalescer.AddMotion(1000, -700, 3);
+                while (coalescer.NextStep(dx, dy, wheel, pan))
+                    ++steps;
+            }
+        }));
+        std::printf("mouse_split_step.steps=%zu\n", steps);
+
+        // A fast fling: the same motion through both mouse profiles.
+        size_t flings = Iterations(200000);
+        for (auto profile : { MouseReportProfile::Standard, MouseReportProfile::HighResolution })
+        {
+            const char* name = profile == MouseReportProfile::Standard ? "mouse_fling_standard" : "mouse_fling_high_resolution";
+            CountingSink flingSink;
+            MouseReportEngine flingMouse(flingSink, profile);
+            Report(name, NanosecondsPerOp(flings, [&] {
+                for (size_t i = 0; i < flings; ++i)
+                {
+                    flingMouse.AddMotion(1000, -700, 3, 2);
+                    flingMouse.FlushMotion();
+                }
+            }));
+            std::printf("%s.reports_per_fling=%.2f\n", name,
+                static_cast<double>(flingSink.m_reports) / static_cast<double>(flings));
+        }
+    }
+
+    void BenchmarkQueue()
+    {
+        size_t events = Iterations(4000000);
+        {
+            InputQueue queue(1024);
+            InputEvent event = InputEvent::MouseMove(1, 1, 0);
+            Report("queue_push_pop", NanosecondsPerOp(events, [&] {
+                for (size_t i = 0; i < events; ++i)
+                {
+                    queue.TryPush(event);
+                    queue.TryPop(event);
+                }
+            }));
+        }
+
+        for (unsigned producers : { 1u, 4u })
+        {
+            InputQueue queue(1024);
+            size_t perProducer = events / producers;
+            std::atomic<bool> go{ false };
+            std::vector<std::thread> threads;
+            for (unsigned p = 0; p < producers; ++p)
+            {
+                threads.emplace_back([&] {
+                    while (!go.load(std::memory_order_acquire))
+                        std::this_thread::yield();
+                    InputEvent event = InputEvent::KeyPress(0x1E);
+                    for (size_t i = 0; i < perProducer; ++i)
+                    {
+                        while (!queue.TryPush(event))
+                            std::this_thread::yield();
+                    }
+                });
+            }
+
+            double nsPerEvent = NanosecondsPerOp(perProducer * producers, [&] {
+                go.store(true, std::memory_order_release);
+                InputEvent event;
+                for (size_t popped = 0; popped < perProducer * producers;)
+                {
+                    if (queue.TryPop(event))
+                        ++popped;
+                }
+            });
+            for (auto& thread : threads)
+                thread.join();
+
+            char name[48];
+            std::snprintf(name, sizeof(name), "queue_%up1c", producers);
+            Report(name, nsPerEvent);
+        }
+    }
+
+    void BenchmarkEndToEnd()
+    {
+        LoopbackReportSink sink;
+        BleEmulator emulator(&sink);
+        emulator.Initialize();
+        // Connection events as tight as the scheduler allows, so the link is not the limit.
+        emulator.SetConnectionInterval(std::chrono::microseconds(1));
+
+        size_t rounds = Iterations(50000);
+        double nsPerEvent = NanosecondsPerOp(rounds * 4, [&] {
+            for (size_t i = 0; i < rounds; ++i)
+            {
+                emulator.VirtualKeyboardPress(0x1E);
+                emulator.VirtualKeyboardRelease(0x1E);
+                emulator.VirtualMouseMove(3, -2, 0);
+                emulator.VirtualMouseMove(-1, 4, 0);
+            }
+            emulator.Flush();
+        });
+        Report("end_to_end_event", nsPerEvent);
+
+        auto stats = emulator.GetStats();
+        std::printf("end_to_end_event.reports=%llu\n", static_cast<unsigned long long>(sink.GetTotalReportCount()));
+        std::printf("end_to_end_event.dispatch_p99_ns=%lld\n", static_cast<long long>(stats.dispatchLatency.p99.count()));
+        std::printf("end_to_end_event.keyboard_p99_ns=%lld\n",
+            static_cast<long long>(stats.reportLatency[static_cast<size_t>(HidReportId::Keyboard)].endToEnd.p99.count()));
+    }
+
+    // Same stream through SubmitEvents(), the way a replay or a foreign caller feeds it.
+    void BenchmarkEndToEndBatch()
+    {
+        LoopbackReportSink sink;
+        BleEmulator emulator(&sink);
+        emulator.Initialize();
+        emulator.SetConnectionInterval(std::chrono::microseconds(1));
+
+        std::vector<InputEvent> batch;
+        for (size_t i = 0; i < 64; ++i)
+        {
+            batch.push_back(InputEvent::KeyPress(0x1E));
+            batch.push_back(InputEvent::KeyRelease(0x1E));
+            batch.push_back(InputEvent::MouseMove(3, -2, 0));
+            batch.push_back(InputEvent::MouseMove(-1, 4, 0));
+        }
+
+        size_t rounds = Iterations(50000 * 4 / batch.size());
+        double nsPerEvent = NanosecondsPerOp(rounds * batch.size(), [&] {
+            for (size_t i = 0; i < rounds; ++i)
+                emulator.SubmitEvents(batch.data(), batch.size());
+            emulator.Flush();
+        });
+        Report("end_to_end_batch", nsPerEvent);
+        std::printf("end_to_end_batch.reports=%llu\n", static_cast<unsigned long long>(sink.GetTotalReportCount()));
+    }
+
+    // The loopback stream decoded the way a host reads it. Every key and button
+    // ends up released and the moves add up to a known distance, so the host
+    // state left behind shows whether the reports meant what was sent.
+    void BenchmarkHostMonitor()
+    {
+        LoopbackReportSink sink;
+        HidReportMonitor monitor;
+        sink.SetReportHandler([&](HidReportId reportId, const uint8_t* data, size_t size) {
+            monitor.OnReport(reportId, data, size);
+        });
+        BleEmulator emulator(&sink);
+        emulator.Initialize();
+        emulator.SetConnectionInterval(std::chrono::microseconds(1));
+
+        constexpr int f1 = 0x3B; // Home on the consumer page with the default key actions
+        size_t rounds = Iterations(20000);
+        double nsPerEvent = NanosecondsPerOp(rounds * 8, [&] {
+            for (size_t i = 0; i < rounds; ++i)
+            {
+                emulator.VirtualKeyboardPress(0x1E);
+                emulator.VirtualKeyboardRelease(0x1E);
+                emulator.VirtualKeyboardPress(f1);
+                emulator.VirtualKeyboardRelease(f1);
+                emulator.VirtualMousePress();
+                emulator.VirtualMouseMove(3, -2, 0);
+                emulator.VirtualMouseRelease();
+                emulator.VirtualMouseMove(-1, 4, 0);
+            }
+            emulator.Flush();
+        });
+        Report("host_monitor", nsPerEvent);
+
+        auto stats = monitor.GetStats();
+        auto state = monitor.GetState();
+        auto expected = static_cast<int64_t>(rounds) * 2;
+        std::printf("host_monitor.decoded_events_per_sec=%.0f\n", stats.eventsPerSecond);
+        std::printf("host_monitor.undecodable=%llu\n", static_cast<unsigned long long>(stats.undecodable));
+        std::printf("host_monitor.keys_left_down=%zu\n", state.keys.count());
+        std::printf("host_monitor.consumer_usage_left=%u\n", static_cast<unsigned>(state.consumerUsage));
+        std::printf("host_monitor.buttons_left_down=%u\n", static_cast<unsigned>(state.mouseButtons));
+        std::printf("host_monitor.pointer_error=%lld\n",
+            static_cast<long long>(std::abs(state.pointerX - expected) + std::abs(state.pointerY - expected)));
+    }
+
+    // Several threads driving one emulator at once, as pointer automation and
+    // a keyboard script would: even producers tap a key of their own, odd
+    // ones move the pointer. Every key ends up released, so any key still
+    // down in the last keyboard report means producers corrupted each other.
+    void BenchmarkProducerScaling()
+    {
+        for (unsigned producers : { 1u, 2u, 4u, 8u })
+        {
+            LoopbackReportSink sink;
+            BleEmulator emulator(&sink);
+            emulator.Initialize();
+            emulator.SetConnectionInterval(std::chrono::microseconds(1));
+
+            size_t perProducer = Iterations(200000) / producers / 2 * 2;
+            std::atomic<bool> go{ false };
+            std::vector<std::thread> threads;
+            for (unsigned p = 0; p < producers; ++p)
+            {
+                threads.emplace_back([&, p] {
+                    while (!go.load(std::memory_order_acquire))
+                        std::this_thread::yield();
+                    int scanCode = 0x10 + static_cast<int>(p / 2); // Q, W, E, R
+                    for (size_t i = 0; i < perProducer; i += 2)
+                    {
+                        if (p % 2 == 0)
+                        {
+                            emulator.VirtualKeyboardPress(scanCode);
+                            emulator.VirtualKeyboardRelease(scanCode);
+                        }
+                        else
+                        {
+                            emulator.VirtualMouseMove(3, -2, 0);
+                            emulator.VirtualMouseMove(-3, 2, 0);
+                        }
+                    }
+                });
+            }
+
+            double nsPerEvent = NanosecondsPerOp(perProducer * producers, [&] {
+                go.store(true, std::memory_order_release);
+                for (auto& thread : threads)
+                    thread.join();
+                emulator.Flush();
+            });
+
+            auto keyboard = sink.GetLastReport(HidReportId::Keyboard);
+            size_t keysDown = 0;
+            for (size_t i = offsetof(KeyboardInputReport, keys); i < keyboard.size(); ++i)
+                keysDown += keyboard[i] != 0;
+
+            auto contention = emulator.GetStats().contention;
+            char name[48];
+            std::snprintf(name, sizeof(name), "producers_%u", producers);
+            Report(name, nsPerEvent);
+            std::printf("%s.queue_retries=%llu\n", name, static_cast<unsigned long long>(contention.queueRetries));
+            std::printf("%s.queue_full=%llu\n", name, static_cast<unsigned long long>(contention.queueFull));
+            std::printf("%s.blocked_submissions=%llu\n", name, static_cast<unsigned long long>(contention.blockedSubmissions));
+            std::printf("%s.blocked_ns=%lld\n", name, static_cast<long long>(contention.blockedTime.count()));
+            std::printf("%s.keys_left_down=%zu\n", name, keysDown);
+        }
+    }
+
+    // The peer directory against stand-in resolvers that take as long as a
+    // BluetoothLEDevice lookup can.
+    void BenchmarkPeerDirectory()
+    {
+        // Connection churn: SetConnected() must never wait for a lookup.
+        {
+            PeerDirectory peers([](const std::string& deviceId) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                return "name of " + deviceId;
+            });
+            size_t rounds = Iterations(2000);
+            Report("peer_set_connected", NanosecondsPerOp(rounds * 2, [&] {
+                for (size_t i = 0; i < rounds; ++i)
+                {
+                    peers.SetConnected({ "steady", "transient-" + std::to_string(i) });
+                    peers.SetConnected({ "steady" });
+                }
+            }));
+            peers.WaitIdle();
+            std::printf("peer_set_connected.peers_left=%zu\n", peers.GetPeers().size());
+        }
+
+        // A device drops and reconnects while its first lookup is running: that
+        // lookup's answer is stale and must not reach the cache or the handler.
+        {
+            std::promise<void> started;
+            std::promise<void> release;
+            auto released = release.get_future().share();
+            int lookup = 0;
+            PeerDirectory peers([&](const std::string&) {
+                if (lookup++ == 0)
+                {
+                    started.set_value();
+                    released.wait();
+                    return std::string("stale");
+                }
+                return std::string("fresh");
+            });
+
+            std::mutex namesMutex;
+            std::vector<std::string> names;
+            peers.SetResolvedHandler([&](const PeerInfo& peer) {
+                std::scoped_lock lock(namesMutex);
+                names.push_back(peer.name);
+            });
+
+            peers.SetConnected({ "central" });
+            started.get_future().wait();
+            peers.SetConnected({});
+            peers.SetConnected({ "central" });
+            release.set_value();
+            peers.WaitIdle();
+
+            size_t staleKept = static_cast<size_t>(std::count(names.begin(), names.end(), "stale"));
+            for (const auto& peer : peers.GetPeers())
+                staleKept += peer.name == "stale";
+            std::printf("peer_reconnect.lookups=%d\n", lookup);
+            std::printf("peer_reconnect.stale_names_kept=%zu\n", staleKept);
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc > 1)
+        g_scale = std::max(std::atof(argv[1]), 0.0001);
+
+    auto scanCodes = KnownScanCodes();
+    BenchmarkScanCodes(scanCodes);
+    BenchmarkKeyboardReports(scanCodes);
+    BenchmarkMouseReports();
+    BenchmarkQueue();
+    BenchmarkEndToEnd();
+    BenchmarkEndToEndBatch();
+    BenchmarkHostMonitor();
+    BenchmarkProducerScaling();
+    BenchmarkPeerDirectory();
+    return 0;
+}
@@ -1,8 +1,9 @@
 ﻿#include "BleEmulator.h"
 #include <iostream>
+#include <string>
 #include <thread>
 
-int main()
+int main(int argc, char* argv[])
 {
     std::cout << "BLE Emulator starting..." << std::endl;
 
@@ -12,6 +13,12 @@ int main()
     // 初始化虚拟鼠标和键盘设备
     emulator.Initialize();
 
+    // 守护模式：接收其他本地进程经共享内存环和控制套接字发来的输入（见 InputClient）
+    std::string serverName = argc > 1 ? argv[1] : "default";
+    if (emulator.StartInputServer(serverName))
+        std::cout << "Input server listening as '" << serverName << "'" << std::endl;
+    else
+        std::cout << "Input server could not start" << std::endl;
 
     // 进入主循环，防止程序退出（你也可以用更优雅的机制，如线程 join 或条件变量）
     while (true)
@@ -0,0 +1,170 @@
+#include "AllocationCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+#ifdef WBLUETOOTH_COUNT_ALLOCATIONS
+
+static std::atomic<uint64_t> s_allocationCount{ 0 };
+
+// Every replaceable form is counted: the aligned ones serve the alignas(64)
+// pipeline objects, the nothrow ones anything that checks for null instead.
+static void* CountedAllocate(std::size_t size)
+{
+    s_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+
+static void* CountedAllocateAligned(std::size_t size, std::align_val_t alignment)
+{
+    s_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    auto align = static_cast<std::size_t>(alignment);
+    if (align < sizeof(void*))
+        align = sizeof(void*);
+#if defined(_WIN32)
+    return _aligned_malloc(size ? size : 1, align);
+#else
+    void* memory = nullptr;
+    return posix_memalign(&memory, align, size ? size : 1) == 0 ? memory : nullptr;
+#endif
+}
+
+static void FreeAligned(void* memory) noexcept
+{
+#if defined(_WIN32)
+    _aligned_free(memory);
+#else
+    std::free(memory);
+#endif
+}
+
+void* operator new(std::size_t size)
+{
+    if (void* memory = CountedAllocate(size))
+        return memory;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return CountedAllocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return CountedAllocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    if (void* memory = CountedAllocateAligned(size, alignment))
+        return memory;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return operator new(size, alignment);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return CountedAllocateAligned(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return CountedAllocateAligned(size, alignment);
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept
+{
+    FreeAligned(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t) noexcept
+{
+    FreeAligned(memory);
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept
+{
+    FreeAligned(memory);
+}
+
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept
+{
+    FreeAligned(memory);
+}
+
+void operator delete(void* memory, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    FreeAligned(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    FreeAligned(memory);
+}
+
+bool AllocationCounter::IsEnabled()
+{
+    return true;
+}
+
+uint64_t AllocationCounter::GetCount()
+{
+    return s_allocationCount.load(std::memory_order_relaxed);
+}
+
+#else
+
+bool AllocationCounter::IsEnabled()
+{
+    return false;
+}
+
+uint64_t AllocationCounter::GetCount()
+{
+    return 0;
+}
+
+#endif
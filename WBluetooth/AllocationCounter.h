@@ -0,0 +1,17 @@
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+
+#include <cstdint>
+
+// Debug aid: counts every global operator new in the process, aligned and
+// nothrow forms included, when the build defines
+// WBLUETOOTH_COUNT_ALLOCATIONS. Sample it before and after a run of
+// reports to check that the steady-state send path does not allocate.
+class AllocationCounter
+{
+public:
+    static bool IsEnabled();
+    static uint64_t GetCount();
+};
+
+#endif // ALLOCATION_COUNTER_H
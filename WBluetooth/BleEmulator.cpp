@@ -1,58 +1,411 @@
 #include "BleEmulator.h"
-#include "VirtualKeyboard.h"
-#include "VirtualMouse.h"
+#include "HidReportSink.h"
+#include "InputDispatcher.h"
+#include "InputLatency.h"
+#include "KeyboardReportEngine.h"
+#include "MouseReportEngine.h"
+#include "DigitizerReportEngine.h"
+#include "EventLog.h"
+#include "LoopbackReportSink.h"
+#include "RedundantReportFilter.h"
+#include "ReportFanOut.h"
+#include "ReportScheduler.h"
+#include "TextReportCompiler.h"
+#include "PointerTrajectory.h"
+#include "InputRecorder.h"
+#include "InputReplayer.h"
+#include "InputServer.h"
+#include "KeyActionTable.h"
+#include "KeyboardLayout.h"
+#include "PeerDirectory.h"
 #include <string>
+#include <array>
+#include <map>
 #include <memory>
-#include <windows.h>
-#include <iostream>
-#include <sstream>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <thread>
 #include <vector>
 
+#ifdef WBLUETOOTH_GATT
+#include "GattReportSink.h"
+#include "VirtualKeyboard.h"
+#include "VirtualMouse.h"
+#include "VirtualHidDevice.h"
+#include <windows.h>
+#endif
+
 class BleEmulatorImpl {
 public:
+    explicit BleEmulatorImpl(HidReportSink* reportSink)
+        : m_reportSink(reportSink) {
+    }
+
+    // Declared ahead of every sink that records into it.
+    InputLatencyStats m_latency;
+    HidReportSink* m_reportSink = nullptr;
+    std::unique_ptr<HidReportSink> m_ownedReportSink;
+#ifdef WBLUETOOTH_GATT
+    // Client transports notify through the characteristics held here.
+    std::unique_ptr<GattReportSink> m_gattSink;
+    std::mutex m_gattClientsMutex;
+    std::map<std::string, GattClientReportSink*> m_gattClients;
+#endif
+    std::unique_ptr<ReportFanOut> m_fanOut;
+    std::unique_ptr<PeerDirectory> m_peers;
+    std::unique_ptr<LatencyProbeSink> m_latencyProbe;
+    ClientOverflowPolicy m_clientOverflowPolicy = ClientOverflowPolicy::Coalesce;
+    std::unique_ptr<ReportScheduler> m_scheduler;
+    std::unique_ptr<RedundantReportFilter> m_reportFilter;
+    std::unique_ptr<KeyboardReportEngine> m_keyboard;
+    std::unique_ptr<MouseReportEngine> m_mouse;
+    std::unique_ptr<DigitizerReportEngine> m_digitizer;
+    BackpressurePolicy m_backpressurePolicy = BackpressurePolicy::Block;
+    std::chrono::microseconds m_connectionInterval = ReportScheduler::m_defaultConnectionInterval;
+
+    // One HID service for all reports instead of one per device class.
+    bool m_compositeDeviceEnabled = false;
+
+    // High-resolution mouse profile, off unless enabled before Initialize().
+    bool m_highResolutionMouseEnabled = false;
+
+    // Key actions for the keyboard engine created by Initialize().
+    KeyActionTable m_keyActions = KeyActionTable::Default();
+
+    // Absolute pointer profile, off unless enabled before Initialize().
+    bool m_absolutePointerEnabled = false;
+    uint32_t m_screenWidth = 0;
+    uint32_t m_screenHeight = 0;
+
+    // Compiled TypeText sequences waiting for the sender thread, by id.
+    std::mutex m_textMutex;
+    KeyboardLayout m_keyboardLayout = KeyboardLayout::UnitedStates();
+    std::map<uint32_t, std::vector<KeyboardInputReport>> m_textSequences;
+    uint32_t m_nextTextSequenceId = 0;
+
+    // Compiled pointer trajectories waiting for the sender thread, by id.
+    std::mutex m_trajectoryMutex;
+    PointerPoint m_pointerRemainder{ 0.0, 0.0 };
+    std::map<uint32_t, std::vector<MotionStep>> m_trajectories;
+    uint32_t m_nextTrajectoryId = 0;
+
+    InputRecorder m_recorder;
+    // Submission time of the oldest motion not yet sent; sender thread only.
+    uint64_t m_motionOrigin = 0;
+#ifdef WBLUETOOTH_GATT
     std::unique_ptr<VirtualKeyboard> m_virtualKeyboard;
     std::unique_ptr<VirtualMouse> m_virtualMouse;
-    std::string m_deviceName;
+    std::unique_ptr<VirtualHidDevice> m_hidDevice;
+#endif
     std::atomic<bool> m_running{ false };
+    // Declared late so the sender thread stops before the engines go away.
+    std::unique_ptr<InputDispatcher> m_dispatcher;
+    // Declared last so other processes stop feeding the dispatcher first.
+    std::unique_ptr<InputServer> m_inputServer;
 
 
     void InitializeVirtualDevices() {
-        m_virtualKeyboard = std::make_unique<VirtualKeyboard>();
-        m_virtualKeyboard->SetSubscribedHidClientsChangedHandler(
-            [this](auto const& clients) { HandleKeyboardSubscribedClientsChanged(clients); });
-        m_virtualKeyboard->Initialize();
-        m_virtualKeyboard->Enable();
-
-        m_virtualMouse = std::make_unique<VirtualMouse>();
-        m_virtualMouse->SetSubscribedHidClientsChangedHandler(
-            [this](auto const& clients) { HandleMouseSubscribedClientsChanged(clients); });
-        m_virtualMouse->Initialize();
-        m_virtualMouse->Enable();
-    }
-
-    void HandleKeyboardSubscribedClientsChanged(IVectorView<GattSubscribedClient> const& clients) {
-        if (clients.Size() > 0) {
-            auto device = BluetoothLEDevice::FromIdAsync(clients.GetAt(0).Session().DeviceId().Id()).get();
-            std::wcout << L"keyboard-subscribed: " << device.Name().c_str() << std::endl;
-            m_deviceName = winrt::to_string(device.Name());
+        if (!m_reportSink) {
+#ifdef WBLUETOOTH_GATT
+            // Every subscribed central gets its own queue, see SyncGattClients().
+            m_gattSink = std::make_unique<GattReportSink>();
+            m_fanOut = std::make_unique<ReportFanOut>(ReportFanOut::m_defaultQueueCapacity, m_clientOverflowPolicy);
+            auto* gattSink = m_gattSink.get();
+            m_peers = std::make_unique<PeerDirectory>([](const std::string& deviceId) {
+                auto device = BluetoothLEDevice::FromIdAsync(winrt::to_hstring(deviceId)).get();
+                return device ? winrt::to_string(device.Name()) : std::string();
+            });
+            m_peers->SetResolvedHandler([](const PeerInfo& peer) {
+                EventLog::WriteText(LogLevel::Info, "subscribed:", peer.name.data(), peer.name.size());
+            });
+
+            if (m_compositeDeviceEnabled) {
+                m_hidDevice = std::make_unique<VirtualHidDevice>();
+                m_hidDevice->SetSubscribedHidClientsChangedHandler(
+                    [this](auto const&) { SyncGattClients(); });
+                VirtualKeyboard::RegisterOn(*m_hidDevice);
+                VirtualMouse::RegisterOn(*m_hidDevice, m_absolutePointerEnabled, m_highResolutionMouseEnabled);
+                m_hidDevice->Initialize();
+                for (auto reportId : { HidReportId::Keyboard, HidReportId::ConsumerControl, HidReportId::Mouse, HidReportId::Digitizer }) {
+                    if (auto characteristic = m_hidDevice->Report(reportId))
+                        gattSink->Attach(reportId, characteristic);
+                }
+                m_hidDevice->Enable();
+            }
+            else {
+                m_virtualKeyboard = std::make_unique<VirtualKeyboard>();
+                m_virtualKeyboard->SetSubscribedHidClientsChangedHandler(
+                    [this](auto const&) { SyncGattClients(); });
+                m_virtualKeyboard->Initialize();
+                gattSink->Attach(HidReportId::Keyboard, m_virtualKeyboard->KeyboardReport());
+                gattSink->Attach(HidReportId::ConsumerControl, m_virtualKeyboard->ConsumerReport());
+                m_virtualKeyboard->Enable();
+
+                m_virtualMouse = std::make_unique<VirtualMouse>();
+                m_virtualMouse->SetSubscribedHidClientsChangedHandler(
+                    [this](auto const&) { SyncGattClients(); });
+                if (m_absolutePointerEnabled)
+                    m_virtualMouse->EnableAbsolutePointer();
+                if (m_highResolutionMouseEnabled)
+                    m_virtualMouse->EnableHighResolution();
+                m_virtualMouse->Initialize();
+                gattSink->Attach(HidReportId::Mouse, m_virtualMouse->MouseReport());
+                if (m_absolutePointerEnabled)
+                    gattSink->Attach(HidReportId::Digitizer, m_virtualMouse->DigitizerReport());
+                m_virtualMouse->Enable();
+            }
+
+            m_reportSink = m_fanOut.get();
+#else
+            m_ownedReportSink = std::make_unique<LoopbackReportSink>();
+            m_reportSink = m_ownedReportSink.get();
+#endif
+        }
+
+        // Client transports behind the fan-out time their own notifications.
+        HidReportSink* transport = m_reportSink;
+        if (!m_fanOut) {
+            m_latencyProbe = std::make_unique<LatencyProbeSink>(*m_reportSink, m_latency);
+            transport = m_latencyProbe.get();
         }
+
+        m_scheduler = std::make_unique<ReportScheduler>(*transport, m_connectionInterval);
+        m_scheduler->Start();
+        m_reportFilter = std::make_unique<RedundantReportFilter>(*m_scheduler);
+        m_keyboard = std::make_unique<KeyboardReportEngine>(*m_reportFilter, m_keyActions);
+        m_mouse = std::make_unique<MouseReportEngine>(*m_reportFilter,
+            m_highResolutionMouseEnabled ? MouseReportProfile::HighResolution : MouseReportProfile::Standard);
+        if (m_absolutePointerEnabled)
+            m_digitizer = std::make_unique<DigitizerReportEngine>(*m_reportFilter, m_screenWidth, m_screenHeight);
+
+        m_dispatcher = std::make_unique<InputDispatcher>(
+            [this](const InputEvent& event, bool moreQueued) { HandleInputEvent(event, moreQueued); },
+            InputDispatcher::m_defaultQueueCapacity, m_backpressurePolicy);
+        m_dispatcher->Start();
+    }
+
+    void Submit(InputEvent event) {
+        event.timestamp = ReportOrigin::Now();
+        m_recorder.Record(event);
+        if (m_dispatcher)
+            m_dispatcher->Submit(event);
+    }
+
+    SubmitStatus SubmitBatch(const InputEvent* events, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            if (!IsPortableEventType(events[i].type))
+                return SubmitStatus::InvalidEvent;
+        }
+        if (!m_dispatcher)
+            return SubmitStatus::NotInitialized;
+
+        m_recorder.Record(events, count);
+        // One call, one submission time for the whole batch.
+        return m_dispatcher->SubmitBatch(events, count, ReportOrigin::Now()) ? SubmitStatus::Ok : SubmitStatus::Dropped;
+    }
+
+    // Batches already checked and stamped, e.g. by InputServer.
+    SubmitStatus SubmitStamped(const InputEvent* events, size_t count) {
+        if (!m_dispatcher)
+            return SubmitStatus::NotInitialized;
+
+        m_recorder.Record(events, count);
+        return m_dispatcher->SubmitBatch(events, count) ? SubmitStatus::Ok : SubmitStatus::Dropped;
+    }
+
+    size_t TypeText(const std::u32string& text) {
+        m_recorder.RecordText(text);
+
+        TextReportCompiler::Result compiled;
+        uint32_t sequenceId = 0;
+        {
+            std::scoped_lock lock(m_textMutex);
+            compiled = TextReportCompiler::Compile(text, m_keyboardLayout);
+            if (compiled.reports.empty() || !m_dispatcher)
+                return compiled.unmappedCharacters;
+
+            sequenceId = m_nextTextSequenceId++;
+            m_textSequences.emplace(sequenceId, std::move(compiled.reports));
+        }
+        Submit(InputEvent::TypeText(sequenceId));
+        return compiled.unmappedCharacters;
     }
 
-    void HandleMouseSubscribedClientsChanged(IVectorView<GattSubscribedClient> const& clients) {
-        if (clients.Size() > 0) {
-            auto device = BluetoothLEDevice::FromIdAsync(clients.GetAt(0).Session().DeviceId().Id()).get();
-            std::wcout << L"mouse-subscribed: " << device.Name().c_str() << std::endl;
-            m_deviceName = winrt::to_string(device.Name());
+    bool MoveAlong(const PointerPath& path) {
+        if (!PointerTrajectory::IsValid(path))
+            return false;
+        m_recorder.RecordPath(path);
+
+        auto reportInterval = m_scheduler ? m_scheduler->GetConnectionInterval() : m_connectionInterval;
+        uint32_t trajectoryId = 0;
+        {
+            std::scoped_lock lock(m_trajectoryMutex);
+            auto steps = PointerTrajectory::Compile(path, reportInterval, m_pointerRemainder,
+                m_highResolutionMouseEnabled ? MouseMotionCoalescer::m_maxHighResolutionDeltaPerReport
+                                             : MouseMotionCoalescer::m_maxDeltaPerReport);
+            if (steps.empty() || !m_dispatcher)
+                return true;
+
+            trajectoryId = m_nextTrajectoryId++;
+            m_trajectories.emplace(trajectoryId, std::move(steps));
         }
+        Submit(InputEvent::MouseTrajectory(trajectoryId));
+        return true;
     }
+
+    void SendTrajectory(uint32_t trajectoryId) {
+        std::vector<MotionStep> steps;
+        {
+            std::scoped_lock lock(m_trajectoryMutex);
+            auto it = m_trajectories.find(trajectoryId);
+            if (it == m_trajectories.end())
+                return;
+            steps = std::move(it->second);
+            m_trajectories.erase(m_trajectories.begin(), std::next(it));
+        }
+        m_mouse->SendMotionSequence(steps.data(), steps.size());
+    }
+
+    void SendTextSequence(uint32_t sequenceId) {
+        std::vector<KeyboardInputReport> reports;
+        {
+            std::scoped_lock lock(m_textMutex);
+            auto it = m_textSequences.find(sequenceId);
+            if (it == m_textSequences.end())
+                return;
+            reports = std::move(it->second);
+            // Anything older was dropped from the queue and will never be asked for.
+            m_textSequences.erase(m_textSequences.begin(), std::next(it));
+        }
+        m_keyboard->SendReportSequence(reports.data(), reports.size());
+    }
+
+    // Runs on the sender thread only. Back-to-back moves are merged and sent
+    // once the queue runs dry, more than a full report has piled up, or a
+    // different event needs to go out after them.
+    void HandleInputEvent(const InputEvent& event, bool moreQueued) {
+        m_latency.RecordDispatch(event.timestamp);
+
+        if (event.type == InputEventType::MouseMove) {
+            if (m_mouse->PendingMotionReportCount() == 0)
+                m_motionOrigin = event.timestamp;
+            ReportOrigin::Scope origin(m_motionOrigin);
+            m_mouse->AddMotion(event.dx, event.dy, event.wheel, event.pan);
+            if (!moreQueued || m_mouse->PendingMotionReportCount() > 1)
+                m_mouse->FlushMotion();
+            return;
+        }
+
+        {
+            ReportOrigin::Scope origin(m_motionOrigin);
+            m_mouse->FlushMotion();
+        }
+        ReportOrigin::Scope origin(event.timestamp);
+        switch (event.type) {
+        case InputEventType::MouseMove: break;
+        case InputEventType::MousePress: m_mouse->Press(static_cast<uint8_t>(event.scanCode)); break;
+        case InputEventType::MouseRelease: m_mouse->Release(static_cast<uint8_t>(event.scanCode)); break;
+        case InputEventType::MouseClick: m_mouse->Click(static_cast<uint8_t>(event.scanCode)); break;
+        case InputEventType::KeyPress: m_keyboard->PressKey(event.scanCode); break;
+        case InputEventType::KeyRelease: m_keyboard->ReleaseKey(event.scanCode); break;
+        case InputEventType::TypeText: SendTextSequence(event.scanCode); break;
+        case InputEventType::MouseTrajectory: SendTrajectory(event.scanCode); break;
+        case InputEventType::AbsoluteMove: if (m_digitizer) m_digitizer->MoveTo(event.dx, event.dy); break;
+        case InputEventType::TouchDown: if (m_digitizer) m_digitizer->TouchDown(event.dx, event.dy); break;
+        case InputEventType::TouchUp: if (m_digitizer) m_digitizer->TouchUp(); break;
+        case InputEventType::Tap: if (m_digitizer) m_digitizer->Tap(event.dx, event.dy); break;
+        }
+    }
+
+#ifdef WBLUETOOTH_GATT
+    // Brings the fan-out clients and the peer cache in line with the subscriptions
+    // on all report characteristics: one client per central, ready for the reports
+    // it subscribed to. Runs in the WinRT event handler, so nothing here waits on
+    // the central; names are looked up by the peer directory's own thread.
+    void SyncGattClients() {
+        static constexpr HidReportId reportIds[] = {
+            HidReportId::Keyboard, HidReportId::ConsumerControl, HidReportId::Mouse, HidReportId::Digitizer };
+
+        struct Subscription {
+            GattSubscribedClient client{ nullptr };
+            std::array<bool, HidReportIdCount> reports{};
+        };
+        std::map<std::string, Subscription> subscriptions;
+        for (auto reportId : reportIds) {
+            auto const& characteristic = m_gattSink->CharacteristicFor(reportId);
+            if (!characteristic)
+                continue;
+            for (auto const& client : characteristic.SubscribedClients()) {
+                auto& subscription = subscriptions[winrt::to_string(client.Session().DeviceId().Id())];
+                subscription.client = client;
+                subscription.reports[static_cast<size_t>(reportId)] = true;
+            }
+        }
+
+        std::vector<std::string> deviceIds;
+        deviceIds.reserve(subscriptions.size());
+        for (auto const& [deviceId, subscription] : subscriptions)
+            deviceIds.push_back(deviceId);
+        m_peers->SetConnected(deviceIds);
+
+        // A central that is new, or newly subscribed to a report, has seen
+        // nothing the filter remembers as delivered.
+        bool subscribed = false;
+        // Removing a client joins its thread, which waits for notifications
+        // still in flight; that happens after the lock is released.
+        std::vector<std::pair<std::string, GattClientReportSink*>> removed;
+        std::unique_lock lock(m_gattClientsMutex);
+        for (auto it = m_gattClients.begin(); it != m_gattClients.end();) {
+            if (subscriptions.count(it->first) == 0) {
+                removed.emplace_back(it->first, it->second);
+                it = m_gattClients.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+        for (auto const& [clientId, subscription] : subscriptions) {
+            auto it = m_gattClients.find(clientId);
+            GattClientReportSink* transport = it != m_gattClients.end() ? it->second : nullptr;
+            if (!transport) {
+                auto created = std::make_unique<GattClientReportSink>(*m_gattSink, subscription.client, &m_latency);
+                transport = created.get();
+                for (auto reportId : reportIds)
+                    transport->SetSubscribed(reportId, subscription.reports[static_cast<size_t>(reportId)]);
+                m_fanOut->AddClient(clientId, std::move(created));
+                m_gattClients.emplace(clientId, transport);
+                subscribed = true;
+                continue;
+            }
+            for (auto reportId : reportIds) {
+                bool wanted = subscription.reports[static_cast<size_t>(reportId)];
+                subscribed = subscribed || (wanted && !transport->IsReady(reportId));
+                transport->SetSubscribed(reportId, wanted);
+            }
+        }
+        lock.unlock();
+
+        for (auto const& [clientId, transport] : removed)
+            m_fanOut->RemoveClient(clientId, transport);
+        if (subscribed && m_reportFilter)
+            m_reportFilter->Invalidate();
+    }
+#endif
 };
 
 BleEmulator::BleEmulator()
-    : pImpl(new BleEmulatorImpl()) {
+    : pImpl(new BleEmulatorImpl(nullptr)) {
+}
+
+BleEmulator::BleEmulator(HidReportSink* reportSink)
+    : pImpl(new BleEmulatorImpl(reportSink)) {
 }
 
 BleEmulator::~BleEmulator() {
     delete pImpl;
+    // Not left to static destruction, which a DLL runs under the loader lock.
+    EventLog::Shutdown();
 }
 
 void BleEmulator::Initialize() {
@@ -64,59 +417,284 @@ void BleEmulator::Test() {
     using namespace std::chrono_literals;
 
     for (int i = 0; i < 10; i++) {
-        pImpl->m_virtualMouse->Move(0, 10, 0);
+        VirtualMouseMove(0, 10, 0);
         std::this_thread::sleep_for(300ms);
     }
 
     for (int i = 0; i < 4; i++) {
-        pImpl->m_virtualMouse->Press();
+        VirtualMousePress();
         std::this_thread::sleep_for(300ms);
 
-        pImpl->m_virtualMouse->Move(100, 0, 0);
+        VirtualMouseMove(100, 0, 0);
         std::this_thread::sleep_for(300ms);
 
-        pImpl->m_virtualMouse->Release();
+        VirtualMouseRelease();
         std::this_thread::sleep_for(300ms);
     }
 
     for (int i = 0; i < 4; i++) {
-        pImpl->m_virtualMouse->Press();
+        VirtualMousePress();
         std::this_thread::sleep_for(300ms);
 
-        pImpl->m_virtualMouse->Move(-100, 0, 0);
+        VirtualMouseMove(-100, 0, 0);
         std::this_thread::sleep_for(300ms);
 
-        pImpl->m_virtualMouse->Release();
+        VirtualMouseRelease();
         std::this_thread::sleep_for(300ms);
     }
 }
 
-void BleEmulator::VirtualMouseMove(int dx, int dy, int wheel)
+void BleEmulator::VirtualMouseMove(int dx, int dy, int wheel, int pan)
+{
+	pImpl->Submit(InputEvent::MouseMove(dx, dy, wheel, pan));
+}
+
+void BleEmulator::VirtualMousePress(uint8_t buttons)
+{
+	pImpl->Submit(InputEvent::MousePress(buttons));
+}
+
+void BleEmulator::VirtualMouseRelease(uint8_t buttons)
+{
+	pImpl->Submit(InputEvent::MouseRelease(buttons));
+}
+
+void BleEmulator::VirtualMouseClick(uint8_t buttons)
+{
+	pImpl->Submit(InputEvent::MouseClick(buttons));
+}
+
+void BleEmulator::EnableHighResolutionMouse()
+{
+    pImpl->m_highResolutionMouseEnabled = true;
+}
+
+void BleEmulator::EnableCompositeDevice()
+{
+    pImpl->m_compositeDeviceEnabled = true;
+}
+
+void BleEmulator::EnableAbsolutePointer(uint32_t screenWidth, uint32_t screenHeight)
 {
-	pImpl->m_virtualMouse->Move(dx, dy, wheel);
+    pImpl->m_absolutePointerEnabled = true;
+    pImpl->m_screenWidth = screenWidth;
+    pImpl->m_screenHeight = screenHeight;
 }
 
-void BleEmulator::VirtualMousePress()
+void BleEmulator::VirtualPointerMoveTo(int x, int y)
 {
-	pImpl->m_virtualMouse->Press();
+    pImpl->Submit(InputEvent::AbsoluteMove(x, y));
 }
 
-void BleEmulator::VirtualMouseRelease()
+void BleEmulator::VirtualTouchDown(int x, int y)
 {
-	pImpl->m_virtualMouse->Release();
+    pImpl->Submit(InputEvent::TouchDown(x, y));
 }
 
-void BleEmulator::VirtualMouseClick()
+void BleEmulator::VirtualTouchUp()
 {
-	pImpl->m_virtualMouse->Click();
+    pImpl->Submit(InputEvent::TouchUp());
+}
+
+void BleEmulator::VirtualTap(int x, int y)
+{
+    pImpl->Submit(InputEvent::Tap(x, y));
 }
 
 void BleEmulator::VirtualKeyboardPress(int ps2Set1ScanCode)
 {
-	pImpl->m_virtualKeyboard->PressKey(ps2Set1ScanCode);
+	pImpl->Submit(InputEvent::KeyPress(ps2Set1ScanCode));
 }
 
 void BleEmulator::VirtualKeyboardRelease(int ps2Set1ScanCode)
 {
-    pImpl->m_virtualKeyboard->ReleaseKey(ps2Set1ScanCode);
+    pImpl->Submit(InputEvent::KeyRelease(ps2Set1ScanCode));
+}
+
+void BleEmulator::MouseMoveTo(double dx, double dy, std::chrono::microseconds duration)
+{
+    pImpl->MoveAlong({ PointerPathShape::Polyline, { { dx, dy } }, duration });
+}
+
+bool BleEmulator::MouseMoveAlong(const PointerPath& path)
+{
+    return pImpl->MoveAlong(path);
+}
+
+SubmitStatus BleEmulator::SubmitEvents(const InputEvent* events, size_t count)
+{
+    return pImpl->SubmitBatch(events, count);
+}
+
+size_t BleEmulator::TypeText(const std::string& utf8)
+{
+    return pImpl->TypeText(TextReportCompiler::DecodeUtf8(utf8));
+}
+
+size_t BleEmulator::TypeText(const std::u32string& utf32)
+{
+    return pImpl->TypeText(utf32);
+}
+
+void BleEmulator::SetKeyboardLayout(const KeyboardLayout& layout)
+{
+    std::scoped_lock lock(pImpl->m_textMutex);
+    pImpl->m_keyboardLayout = layout;
+}
+
+void BleEmulator::SetKeyActions(const KeyActionTable& actions)
+{
+    pImpl->m_keyActions = actions;
+    if (pImpl->m_keyboard)
+        pImpl->m_keyboard->SetKeyActions(actions);
+}
+
+void BleEmulator::SetBackpressurePolicy(BackpressurePolicy policy)
+{
+    pImpl->m_backpressurePolicy = policy;
+    if (pImpl->m_dispatcher)
+        pImpl->m_dispatcher->SetBackpressurePolicy(policy);
+}
+
+void BleEmulator::Flush()
+{
+    if (pImpl->m_dispatcher)
+        pImpl->m_dispatcher->Flush();
+    if (pImpl->m_scheduler)
+        pImpl->m_scheduler->Flush();
+    if (pImpl->m_fanOut)
+        pImpl->m_fanOut->Flush();
+}
+
+void BleEmulator::SetConnectionInterval(std::chrono::microseconds interval)
+{
+    pImpl->m_connectionInterval = interval;
+    if (pImpl->m_scheduler)
+        pImpl->m_scheduler->SetConnectionInterval(interval);
+}
+
+SchedulerStats BleEmulator::GetSchedulerStats() const
+{
+    if (!pImpl->m_scheduler)
+        return {};
+    return pImpl->m_scheduler->GetStats();
+}
+
+bool BleEmulator::StartRecording(const std::string& path)
+{
+    return pImpl->m_recorder.Open(path);
+}
+
+void BleEmulator::StopRecording()
+{
+    pImpl->m_recorder.Close();
+}
+
+size_t BleEmulator::Replay(const std::string& path, ReplayTiming timing)
+{
+    InputReplayer replayer;
+    if (!replayer.Open(path))
+        return 0;
+
+    size_t replayed = replayer.Play([this](const InputTrace::Record& record) {
+        if (record.event.type == InputEventType::TypeText)
+            pImpl->TypeText(record.text);
+        else
+            pImpl->MoveAlong(record.path);
+    }, [this](const InputEvent* events, size_t count) {
+        pImpl->SubmitBatch(events, count);
+    }, timing);
+
+    Flush();
+    return replayed;
+}
+
+bool BleEmulator::StartInputServer(const std::string& name)
+{
+    StopInputServer();
+    InputServer::Handlers handlers;
+    handlers.submit = [this](const InputEvent* events, size_t count) { return pImpl->SubmitStamped(events, count); };
+    handlers.typeText = [this](const std::string& utf8) { return TypeText(utf8); };
+    handlers.flush = [this] { Flush(); };
+
+    auto server = std::make_unique<InputServer>(std::move(handlers));
+    if (!server->Start(name))
+        return false;
+    pImpl->m_inputServer = std::move(server);
+    return true;
+}
+
+void BleEmulator::StopInputServer()
+{
+    pImpl->m_inputServer.reset();
+}
+
+InputServerStats BleEmulator::GetInputServerStats() const
+{
+    if (!pImpl->m_inputServer)
+        return {};
+    return pImpl->m_inputServer->GetStats();
+}
+
+void BleEmulator::SetClientOverflowPolicy(ClientOverflowPolicy policy)
+{
+    pImpl->m_clientOverflowPolicy = policy;
+    if (pImpl->m_fanOut)
+        pImpl->m_fanOut->SetOverflowPolicy(policy);
+}
+
+std::vector<ClientStats> BleEmulator::GetClientStats() const
+{
+    if (!pImpl->m_fanOut)
+        return {};
+    return pImpl->m_fanOut->GetClientStats();
+}
+
+std::vector<PeerInfo> BleEmulator::GetPeers() const
+{
+    if (!pImpl->m_peers)
+        return {};
+    return pImpl->m_peers->GetPeers();
+}
+
+InputStats BleEmulator::GetStats() const
+{
+    InputStats stats{};
+    stats.elapsed = pImpl->m_latency.GetElapsed();
+    double seconds = std::chrono::duration<double>(stats.elapsed).count();
+
+    stats.dispatchLatency = pImpl->m_latency.GetDispatchLatency();
+    stats.events = stats.dispatchLatency.count;
+    stats.eventsPerSecond = seconds > 0.0 ? static_cast<double>(stats.events) / seconds : 0.0;
+    if (pImpl->m_dispatcher) {
+        stats.droppedEvents = pImpl->m_dispatcher->GetDroppedCount();
+        stats.coalescedEvents = pImpl->m_dispatcher->GetCoalescedCount();
+        stats.queueDepth = pImpl->m_dispatcher->GetQueueDepth();
+        stats.contention = pImpl->m_dispatcher->GetContention();
+    }
+
+    stats.reports = pImpl->m_latency.GetReportCount();
+    stats.reportsPerSecond = seconds > 0.0 ? static_cast<double>(stats.reports) / seconds : 0.0;
+    for (size_t id = 0; id < HidReportIdCount; ++id) {
+        stats.reportLatency[id] = pImpl->m_latency.GetReportLatency(static_cast<HidReportId>(id));
+        stats.reportCounters[id] = GetReportCounters(static_cast<HidReportId>(id));
+    }
+
+    stats.scheduler = GetSchedulerStats();
+    stats.clients = GetClientStats();
+    return stats;
+}
+
+void BleEmulator::ResetStats()
+{
+    pImpl->m_latency.Reset();
+    if (pImpl->m_inputServer)
+        pImpl->m_inputServer->ResetStats();
+}
+
+ReportCounters BleEmulator::GetReportCounters(HidReportId reportId) const
+{
+    if (!pImpl->m_reportFilter)
+        return {};
+    return pImpl->m_reportFilter->GetCounters(reportId);
 }
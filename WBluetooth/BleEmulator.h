@@ -1,32 +1,128 @@
 #ifndef BLE_EMULATOR_H
 #define BLE_EMULATOR_H
 
+#if defined(_WIN32)
 #ifdef BLEEMULATOR_EXPORTS
 #define BLEEMULATOR_API __declspec(dllexport)
 #else
 #define BLEEMULATOR_API __declspec(dllimport)
 #endif
+#else
+#define BLEEMULATOR_API
+#endif
+
+#include "BleEmulatorTypes.h"
+#include "InputEvent.h"
+#include <chrono>
+#include <string>
+#include <vector>
 
 class BleEmulatorImpl;
-class VirtualMouse;
-class VirtualKeyboard;
+class HidReportSink;
+class KeyActionTable;
+class KeyboardLayout;
+struct PointerPath;
 
 class BLEEMULATOR_API BleEmulator {
 public:
     BleEmulator();
+    // Sends reports to the given transport instead of the built-in one. Not owned.
+    explicit BleEmulator(HidReportSink* reportSink);
     ~BleEmulator();
 
+    // Serves keyboard, consumer control and mouse reports from one HID
+    // service with a single report map, so a central discovers, subscribes
+    // to and keeps one service. Call before Initialize().
+    void EnableCompositeDevice();
+
     void Initialize();
     void Test();
 
-    void VirtualMouseMove(int dx, int dy, int wheel = 0);
-    void VirtualMousePress();
-    void VirtualMouseRelease();
-    void VirtualMouseClick();
+    // Buttons are MouseButton masks; pan scrolls horizontally.
+    void VirtualMouseMove(int dx, int dy, int wheel = 0, int pan = 0);
+    void VirtualMousePress(uint8_t buttons = MouseButton::Left);
+    void VirtualMouseRelease(uint8_t buttons = MouseButton::Left);
+    void VirtualMouseClick(uint8_t buttons = MouseButton::Left);
+
+    // High-resolution mouse profile: five buttons and 16-bit X, Y, wheel and
+    // pan, so a large move or scroll goes out in one report instead of one
+    // per 127 counts. Without it only Left and Right are reported and pan is
+    // dropped. Call before Initialize().
+    void EnableHighResolutionMouse();
+
+    // Moves the pointer by (dx, dy) over duration, spread over the connection
+    // events it spans. Sub-pixel parts carry over to the next move.
+    void MouseMoveTo(double dx, double dy, std::chrono::microseconds duration);
+    // Same along a polyline or cubic Bezier path; false if the path is malformed.
+    bool MouseMoveAlong(const PointerPath& path);
+
+    // Optional touch screen profile for a screenWidth x screenHeight display,
+    // placing the pointer in one report. Call before Initialize().
+    void EnableAbsolutePointer(uint32_t screenWidth, uint32_t screenHeight);
+    void VirtualPointerMoveTo(int x, int y);
+    void VirtualTouchDown(int x, int y);
+    void VirtualTouchUp();
+    void VirtualTap(int x, int y);
 
     void VirtualKeyboardPress(int ps2Set1ScanCode);
     void VirtualKeyboardRelease(int ps2Set1ScanCode);
 
+    // Queues a packed array of events with one call and one pass over the
+    // queue, for callers across a language boundary or replaying input. The
+    // batch is checked first and taken all or none: TypeText and
+    // MouseTrajectory have no place in it, use TypeText() and MouseMoveAlong().
+    SubmitStatus SubmitEvents(const InputEvent* events, size_t count);
+
+    // Types text on the current layout; returns how many characters it has no key for.
+    size_t TypeText(const std::string& utf8);
+    size_t TypeText(const std::u32string& utf32);
+    void SetKeyboardLayout(const KeyboardLayout& layout);
+    // What each key does: itself, a consumer control key, or a report
+    // sequence such as a chord. Takes effect from the next key press, also
+    // while input is flowing.
+    void SetKeyActions(const KeyActionTable& actions);
+
+    // Input calls above only queue the event; a sender thread transmits it.
+    // They may come from any number of threads at once. Events take their
+    // place in one global order as they enter the queue, so each thread's
+    // calls keep their order and the sender thread, the only one that
+    // touches keyboard and pointer state, applies them in that order.
+    void SetBackpressurePolicy(BackpressurePolicy policy);
+    // Blocks until every event queued so far has been sent.
+    void Flush();
+
+    // Reports go out on connection event deadlines spaced this far apart.
+    void SetConnectionInterval(std::chrono::microseconds interval);
+    SchedulerStats GetSchedulerStats() const;
+
+    // Appends every input call from now on to a binary trace file.
+    bool StartRecording(const std::string& path);
+    void StopRecording();
+    // Feeds a recorded trace back through the input calls; returns the number
+    // of calls replayed, or 0 if the file is not a trace.
+    size_t Replay(const std::string& path, ReplayTiming timing);
+
+    // Daemon mode: takes input from other local processes through a shared
+    // memory ring and a control socket named after name (see InputClient).
+    bool StartInputServer(const std::string& name);
+    void StopInputServer();
+    InputServerStats GetInputServerStats() const;
+
+    // How each central's queue sheds load when it falls behind the others.
+    void SetClientOverflowPolicy(ClientOverflowPolicy policy);
+    // Delivery and backlog per subscribed central; empty unless reports go out over GATT.
+    std::vector<ClientStats> GetClientStats() const;
+    // Connected centrals and their names, as far as they have been looked up yet.
+    std::vector<PeerInfo> GetPeers() const;
+
+    // Latency percentiles, throughput, drops and queue depths. Recording is
+    // always on; ResetStats() restarts the latency and throughput window.
+    InputStats GetStats() const;
+    void ResetStats();
+
+    // Reports delivered vs. dropped as redundant, per report ID.
+    ReportCounters GetReportCounters(HidReportId reportId) const;
+
 private:
     BleEmulatorImpl* pImpl;
 };
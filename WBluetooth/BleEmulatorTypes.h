@@ -0,0 +1,140 @@
+#ifndef BLE_EMULATOR_TYPES_H
+#define BLE_EMULATOR_TYPES_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Plain data that crosses the BleEmulator interface: report IDs, policies and
+// statistics. Kept apart from the classes that produce them, so BleEmulator.h
+// pulls in no threads, locks or queues.
+
+// Report IDs as declared in the keyboard and mouse report maps.
+enum class HidReportId : uint8_t
+{
+    Keyboard = 0x01,
+    ConsumerControl = 0x02,
+    Mouse = 0x03,
+    Digitizer = 0x04
+};
+
+// One past the highest report ID, for tables indexed by report ID.
+constexpr size_t HidReportIdCount = 5;
+
+enum class ReplayTiming : uint8_t
+{
+    Original,        // keep the recorded gaps between calls
+    AsFastAsPossible // as fast as the sender thread takes them
+};
+
+// What a client queue does when its central cannot keep up.
+enum class ClientOverflowPolicy : uint8_t
+{
+    DropOldest, // discard the oldest queued report once the queue is full
+    Coalesce    // fold motion into a queued mouse report, drop the oldest once full
+};
+
+struct ClientStats
+{
+    std::string clientId;
+    uint64_t delivered;
+    uint64_t dropped;
+    uint64_t coalesced;
+    size_t backlog;
+    size_t maxBacklog;
+    // From queueing to acceptance by the client's transport.
+    std::chrono::microseconds meanLatency;
+    std::chrono::microseconds maxLatency;
+};
+
+struct PeerInfo
+{
+    std::string deviceId;
+    std::string name;                       // empty until resolved, or if the lookup failed
+    bool resolved;
+    std::chrono::microseconds resolveTime;  // how long the lookup took
+};
+
+struct LatencySummary
+{
+    uint64_t count;
+    std::chrono::nanoseconds mean;
+    std::chrono::nanoseconds p50;
+    std::chrono::nanoseconds p90;
+    std::chrono::nanoseconds p99;
+    std::chrono::nanoseconds p999;
+    std::chrono::nanoseconds max;
+};
+
+struct ReportLatency
+{
+    LatencySummary queued;      // origin to transmit start
+    LatencySummary transmit;    // transmit start to completion
+    LatencySummary endToEnd;    // origin to completion
+    uint64_t failed;            // transmits that failed or were cancelled, not timed above
+};
+
+struct ReportCounters
+{
+    uint64_t sent;
+    uint64_t suppressed;
+};
+
+// How much producer threads got in each other's way on the way into the queue.
+struct ProducerContention
+{
+    uint64_t queueRetries;              // pushes that lost a cell to another producer
+    uint64_t queueFull;                 // pushes turned away by a full queue
+    uint64_t blockedSubmissions;        // events whose producer waited for room
+    std::chrono::nanoseconds blockedTime; // spent waiting, over all producers
+};
+
+struct SchedulerStats
+{
+    uint64_t connectionEvents;  // events that carried at least one report
+    uint64_t reportsSent;
+    uint64_t deferredReports;   // moved to a later event because theirs was full
+    uint64_t blockedReports;    // whose sender waited for their report ID's backlog to shrink
+    std::chrono::nanoseconds blockedTime;
+    std::chrono::nanoseconds meanWakeJitter;
+    std::chrono::nanoseconds maxWakeJitter;
+};
+
+struct InputServerStats
+{
+    uint64_t ringEvents;        // taken from the shared ring
+    uint64_t socketEvents;      // taken from batches on the control socket
+    uint64_t rejectedEvents;    // malformed, or of a type that cannot cross processes
+    uint64_t lossyBatches;      // handed on, but motion was discarded or nothing could be queued
+    uint64_t messages;          // control socket messages answered
+    size_t clients;             // control socket connections open now
+    LatencySummary transferLatency; // producer time stamp to pickup by the daemon
+};
+
+// Snapshot of the whole input path, from the public calls to the transport.
+struct InputStats
+{
+    std::chrono::nanoseconds elapsed;           // since Initialize() or ResetStats()
+
+    uint64_t events;
+    double eventsPerSecond;
+    uint64_t droppedEvents;
+    uint64_t coalescedEvents;
+    size_t queueDepth;
+    ProducerContention contention;              // between threads making input calls
+    LatencySummary dispatchLatency;             // public call to the sender thread
+
+    uint64_t reports;
+    double reportsPerSecond;
+    // By report ID: latency up to transport completion, delivered vs. suppressed.
+    std::array<ReportLatency, HidReportIdCount> reportLatency;
+    std::array<ReportCounters, HidReportIdCount> reportCounters;
+
+    SchedulerStats scheduler;
+    std::vector<ClientStats> clients;           // per central, over GATT
+};
+
+#endif // BLE_EMULATOR_TYPES_H
@@ -0,0 +1,63 @@
+#include "DigitizerReportEngine.h"
+#include <algorithm>
+
+DigitizerReportEngine::DigitizerReportEngine(HidReportSink& sink, uint32_t screenWidth, uint32_t screenHeight)
+    : m_sink(sink)
+    , m_screenWidth(std::max<uint32_t>(screenWidth, 1))
+    , m_screenHeight(std::max<uint32_t>(screenHeight, 1))
+{
+}
+
+uint16_t DigitizerReportEngine::ToLogical(int coordinate, uint32_t extent)
+{
+    if (extent <= 1 || coordinate <= 0)
+        return 0;
+    if (static_cast<uint32_t>(coordinate) >= extent - 1)
+        return m_logicalMaximum;
+
+    // Rounded, so the last pixel lands on the logical maximum and the first on zero.
+    uint64_t scaled = static_cast<uint64_t>(coordinate) * m_logicalMaximum;
+    return static_cast<uint16_t>((scaled + (extent - 1) / 2) / (extent - 1));
+}
+
+void DigitizerReportEngine::MoveTo(int x, int y)
+{
+    SendState(false, ToLogical(x, m_screenWidth), ToLogical(y, m_screenHeight));
+}
+
+void DigitizerReportEngine::TouchDown(int x, int y)
+{
+    SendState(true, ToLogical(x, m_screenWidth), ToLogical(y, m_screenHeight));
+}
+
+void DigitizerReportEngine::TouchUp()
+{
+    SendState(false, m_lastX, m_lastY);
+}
+
+void DigitizerReportEngine::Tap(int x, int y)
+{
+    TouchDown(x, y);
+    SendState(false, m_lastX, m_lastY, m_tapHoldTime);
+}
+
+void DigitizerReportEngine::SendState(bool tipDown, uint16_t x, uint16_t y, std::chrono::microseconds delay)
+{
+    if (!m_sink.IsReady(HidReportId::Digitizer))
+        return;
+
+    DigitizerInputReport report;
+    report.flags = (tipDown ? 0x01 : 0x00) | 0x02;
+    report.xLow = static_cast<uint8_t>(x & 0xFF);
+    report.xHigh = static_cast<uint8_t>(x >> 8);
+    report.yLow = static_cast<uint8_t>(y & 0xFF);
+    report.yHigh = static_cast<uint8_t>(y >> 8);
+
+    m_lastX = x;
+    m_lastY = y;
+
+    if (delay.count() > 0)
+        m_sink.SendReportAfter(HidReportId::Digitizer, reinterpret_cast<const uint8_t*>(&report), sizeof(report), delay);
+    else
+        m_sink.SendReport(HidReportId::Digitizer, reinterpret_cast<const uint8_t*>(&report), sizeof(report));
+}
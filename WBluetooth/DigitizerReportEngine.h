@@ -0,0 +1,46 @@
+#ifndef DIGITIZER_REPORT_ENGINE_H
+#define DIGITIZER_REPORT_ENGINE_H
+
+#include "HidReportSink.h"
+#include "HidReportMaps.h"
+#include <chrono>
+#include <cstdint>
+
+// Absolute pointer report generation for the optional touch screen profile,
+// independent of the transport. Screen pixels are scaled to the 0..32767
+// logical range of the report map, so one report places the contact exactly.
+class DigitizerReportEngine
+{
+public:
+    static constexpr uint32_t m_sizeOfDigitizerReportDataInBytes =
+        HidDescriptor::InputReportBits(HidReportMaps::Digitizer, HidReportMaps::DigitizerReportId) / 8;
+    static constexpr uint16_t m_logicalMaximum = 0x7FFF;
+    static constexpr std::chrono::milliseconds m_tapHoldTime{ 40 };
+
+    DigitizerReportEngine(HidReportSink& sink, uint32_t screenWidth, uint32_t screenHeight);
+
+    // Hovers over (x, y) without touching.
+    void MoveTo(int x, int y);
+    void TouchDown(int x, int y);
+    // Lifts the contact where it is.
+    void TouchUp();
+    // Touches (x, y); the sink sends the lift after the hold time.
+    void Tap(int x, int y);
+
+    // Maps a pixel on a screen extent pixels wide to the logical range, clamping to the edges.
+    static uint16_t ToLogical(int coordinate, uint32_t extent);
+
+private:
+    void SendState(bool tipDown, uint16_t x, uint16_t y,
+        std::chrono::microseconds delay = std::chrono::microseconds::zero());
+
+    HidReportSink& m_sink;
+    uint32_t m_screenWidth;
+    uint32_t m_screenHeight;
+
+    // State Variables
+    uint16_t m_lastX = 0;
+    uint16_t m_lastY = 0;
+};
+
+#endif // DIGITIZER_REPORT_ENGINE_H
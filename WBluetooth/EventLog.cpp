@@ -0,0 +1,457 @@
+#include "EventLog.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+    constexpr size_t m_ringCapacity = 256;
+    constexpr auto m_drainInterval = std::chrono::milliseconds(20);
+    constexpr uint64_t m_rateWindow = 1000000000;   // ns
+
+    uint64_t Now()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    struct Record {
+        uint64_t timestamp;
+        const char* message;
+        uint16_t size;              // of the payload as written, may exceed data
+        LogLevel level;
+        LogPayload payload;
+        uint8_t data[EventLog::m_payloadCapacity];
+    };
+
+    // Single producer (the owning thread), single consumer (the drain).
+    struct ThreadRing {
+        std::array<Record, m_ringCapacity> records;
+        alignas(64) std::atomic<uint32_t> head{ 0 };
+        alignas(64) std::atomic<uint32_t> tail{ 0 };
+        std::atomic<uint64_t> dropped{ 0 };
+        std::atomic<bool> abandoned{ false };
+    };
+
+    struct RateState {
+        uint64_t windowStart = 0;
+        uint32_t count = 0;
+        uint32_t suppressed = 0;
+    };
+
+    class Logger
+    {
+    public:
+        // Deliberately never destroyed, see EventLog::Shutdown().
+        static Logger& Instance()
+        {
+            static Logger* logger = new Logger();
+            return *logger;
+        }
+
+        // A write that finds the drain stopped starts it again, unless a
+        // Shutdown() is under way; the record then waits for the next start.
+        void Start()
+        {
+            std::unique_lock lifecycle(m_lifecycleMutex, std::try_to_lock);
+            if (!lifecycle)
+                return;
+            std::scoped_lock lock(m_mutex);
+            if (m_running)
+                return;
+            m_running = true;
+            m_draining.store(true, std::memory_order_release);
+            m_drainThread = std::thread(&Logger::DrainLoop, this);
+        }
+
+        void Shutdown()
+        {
+            std::scoped_lock lifecycle(m_lifecycleMutex);
+            {
+                std::scoped_lock lock(m_mutex);
+                if (!m_running)
+                    return;
+                m_running = false;
+                m_draining.store(false, std::memory_order_relaxed);
+            }
+            m_wakeCondition.notify_one();
+            m_drainThread.join();
+        }
+
+        std::atomic<uint8_t> m_level{ static_cast<uint8_t>(LogLevel::Info) };
+        std::atomic<uint32_t> m_rateLimit{ 10 };
+
+        void Push(LogLevel level, const char* message, LogPayload payload, const void* data, size_t size)
+        {
+            if (!m_draining.load(std::memory_order_acquire))
+                Start();
+
+            ThreadRing& ring = LocalRing();
+            uint32_t head = ring.head.load(std::memory_order_relaxed);
+            if (head - ring.tail.load(std::memory_order_acquire) == m_ringCapacity)
+            {
+                ring.dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+
+            Record& record = ring.records[head % m_ringCapacity];
+            record.timestamp = Now();
+            record.message = message;
+            record.level = level;
+            record.payload = payload;
+            record.size = static_cast<uint16_t>(std::min<size_t>(size, UINT16_MAX));
+            if (size != 0)
+                std::memcpy(record.data, data, std::min(size, EventLog::m_payloadCapacity));
+            ring.head.store(head + 1, std::memory_order_release);
+        }
+
+        void SetOutput(EventLog::Output output)
+        {
+            std::scoped_lock lock(m_mutex);
+            m_output = std::move(output);
+        }
+
+        void Flush()
+        {
+            if (!m_draining.load(std::memory_order_acquire))
+                Start();
+
+            std::unique_lock lock(m_mutex);
+            uint64_t target = m_passesStarted + 1;
+            m_flushRequested = true;
+            m_wakeCondition.notify_one();
+            m_passCondition.wait(lock, [&] { return m_passesDone >= target || !m_running; });
+        }
+
+        LogStats GetStats()
+        {
+            std::scoped_lock lock(m_mutex);
+            LogStats stats{ m_written, m_dropped, m_suppressed };
+            for (const auto& ring : m_rings)
+                stats.dropped += ring->dropped.load(std::memory_order_relaxed);
+            return stats;
+        }
+
+    private:
+        // Keeps the thread's ring registered; the drain frees it once the
+        // thread has exited and everything is read.
+        struct RingHandle {
+            std::shared_ptr<ThreadRing> ring;
+            ~RingHandle()
+            {
+                if (ring)
+                    ring->abandoned.store(true, std::memory_order_release);
+            }
+        };
+
+        Logger()
+            : m_startTime(Now())
+        {
+            Start();
+        }
+
+        ThreadRing& LocalRing()
+        {
+            thread_local RingHandle handle;
+            if (!handle.ring)
+            {
+                handle.ring = std::make_shared<ThreadRing>();
+                std::scoped_lock lock(m_mutex);
+                m_rings.push_back(handle.ring);
+            }
+            return *handle.ring;
+        }
+
+        void DrainLoop()
+        {
+            std::unique_lock lock(m_mutex);
+            while (true)
+            {
+                m_wakeCondition.wait_for(lock, m_drainInterval, [&] { return m_flushRequested || !m_running; });
+                bool stopping = !m_running;
+                m_flushRequested = false;
+                ++m_passesStarted;
+
+                auto rings = m_rings;
+                auto output = m_output;
+                lock.unlock();
+                Drain(rings, output);
+                lock.lock();
+
+                // Rings of exited threads go once the pass has emptied them.
+                m_rings.erase(std::remove_if(m_rings.begin(), m_rings.end(), [&](const auto& ring) {
+                    if (!ring->abandoned.load(std::memory_order_acquire) ||
+                        ring->head.load(std::memory_order_acquire) != ring->tail.load(std::memory_order_relaxed))
+                        return false;
+                    m_dropped += ring->dropped.load(std::memory_order_relaxed);
+                    m_droppedReported.erase(ring.get());
+                    return true;
+                }), m_rings.end());
+
+                ++m_passesDone;
+                m_passCondition.notify_all();
+                if (stopping)
+                    return;
+            }
+        }
+
+        // Runs on the drain thread only, which owns everything below m_rate.
+        void Drain(const std::vector<std::shared_ptr<ThreadRing>>& rings, const EventLog::Output& output)
+        {
+            m_batch.clear();
+            uint64_t dropped = 0;
+            for (const auto& ring : rings)
+            {
+                uint32_t tail = ring->tail.load(std::memory_order_relaxed);
+                uint32_t head = ring->head.load(std::memory_order_acquire);
+                for (; tail != head; ++tail)
+                    m_batch.push_back(ring->records[tail % m_ringCapacity]);
+                ring->tail.store(tail, std::memory_order_release);
+
+                uint64_t total = ring->dropped.load(std::memory_order_relaxed);
+                auto& reported = m_droppedReported[ring.get()];
+                dropped += total - reported;
+                reported = total;
+            }
+            std::stable_sort(m_batch.begin(), m_batch.end(), [](const Record& a, const Record& b) {
+                return a.timestamp < b.timestamp;
+            });
+
+            uint64_t now = Now();
+            auto minimum = static_cast<LogLevel>(m_level.load(std::memory_order_relaxed));
+            uint32_t rateLimit = m_rateLimit.load(std::memory_order_relaxed);
+            uint64_t written = 0;
+            uint64_t suppressed = 0;
+
+            for (const auto& record : m_batch)
+            {
+                if (record.level < minimum)
+                    continue;
+
+                if (rateLimit != 0)
+                {
+                    auto& rate = m_rate[record.message];
+                    if (record.timestamp - rate.windowStart >= m_rateWindow)
+                    {
+                        ReportSuppressed(record.message, rate, record.level, output);
+                        rate.windowStart = record.timestamp;
+                        rate.count = 0;
+                    }
+                    if (++rate.count > rateLimit)
+                    {
+                        ++rate.suppressed;
+                        ++suppressed;
+                        continue;
+                    }
+                }
+
+                Emit(record.level, Format(record), output);
+                ++written;
+            }
+
+            for (auto& [message, rate] : m_rate)
+            {
+                if (now - rate.windowStart >= m_rateWindow)
+                    ReportSuppressed(message, rate, LogLevel::Warning, output);
+            }
+            if (dropped != 0)
+            {
+                char line[96];
+                std::snprintf(line, sizeof(line), "%s W [EventLog] %llu records dropped, ring full",
+                    Timestamp(now).c_str(), static_cast<unsigned long long>(dropped));
+                Emit(LogLevel::Warning, line, output);
+            }
+
+            std::scoped_lock lock(m_mutex);
+            m_written += written;
+            m_suppressed += suppressed;
+        }
+
+        void ReportSuppressed(const char* message, RateState& rate, LogLevel level, const EventLog::Output& output)
+        {
+            if (rate.suppressed == 0)
+                return;
+            std::string line = Timestamp(Now()) + " " + LevelLetter(level) + " " + message +
+                " (" + std::to_string(rate.suppressed) + " more suppressed)";
+            Emit(level, line, output);
+            rate.suppressed = 0;
+        }
+
+        static void Emit(LogLevel level, const std::string& line, const EventLog::Output& output)
+        {
+            if (output)
+            {
+                output(level, line);
+                return;
+            }
+            std::fputs(line.c_str(), stderr);
+            std::fputc('\n', stderr);
+        }
+
+        static char LevelLetter(LogLevel level)
+        {
+            switch (level)
+            {
+            case LogLevel::Debug: return 'D';
+            case LogLevel::Info: return 'I';
+            case LogLevel::Warning: return 'W';
+            default: return 'E';
+            }
+        }
+
+        std::string Timestamp(uint64_t timestamp) const
+        {
+            uint64_t elapsed = timestamp > m_startTime ? timestamp - m_startTime : 0;
+            char text[32];
+            std::snprintf(text, sizeof(text), "[%6llu.%06llu]",
+                static_cast<unsigned long long>(elapsed / 1000000000),
+                static_cast<unsigned long long>(elapsed / 1000 % 1000000));
+            return text;
+        }
+
+        std::string Format(const Record& record) const
+        {
+            std::string line = Timestamp(record.timestamp);
+            line += ' ';
+            line += LevelLetter(record.level);
+            line += ' ';
+            line += record.message;
+
+            size_t stored = std::min<size_t>(record.size, EventLog::m_payloadCapacity);
+            char text[24];
+            switch (record.payload)
+            {
+            case LogPayload::Value:
+            {
+                uint64_t value;
+                std::memcpy(&value, record.data, sizeof(value));
+                std::snprintf(text, sizeof(text), " 0x%02llX", static_cast<unsigned long long>(value));
+                line += text;
+                break;
+            }
+            case LogPayload::Bytes:
+                for (size_t i = 0; i < stored; ++i)
+                {
+                    std::snprintf(text, sizeof(text), " %02X", record.data[i]);
+                    line += text;
+                }
+                break;
+            case LogPayload::Text:
+                line += ' ';
+                line.append(reinterpret_cast<const char*>(record.data), stored);
+                break;
+            default:
+                break;
+            }
+            if (record.size > stored)
+                line += " ... (" + std::to_string(record.size) + " bytes)";
+            return line;
+        }
+
+        uint64_t m_startTime;
+
+        // Serializes Start() and Shutdown(); never taken by the drain thread.
+        std::mutex m_lifecycleMutex;
+        std::atomic<bool> m_draining{ false };
+
+        std::mutex m_mutex;
+        std::condition_variable m_wakeCondition;
+        std::condition_variable m_passCondition;
+        std::vector<std::shared_ptr<ThreadRing>> m_rings;
+        EventLog::Output m_output;
+        bool m_running = false;
+        bool m_flushRequested = false;
+        uint64_t m_passesStarted = 0;
+        uint64_t m_passesDone = 0;
+        uint64_t m_written = 0;
+        uint64_t m_dropped = 0;
+        uint64_t m_suppressed = 0;
+
+        std::unordered_map<const char*, RateState> m_rate;
+        std::unordered_map<const ThreadRing*, uint64_t> m_droppedReported;
+        std::vector<Record> m_batch;
+
+        std::thread m_drainThread;
+    };
+
+    void Push(LogLevel level, const char* message, LogPayload payload, const void* data, size_t size)
+    {
+        if (!EventLog::IsEnabled(level))
+            return;
+        Logger::Instance().Push(level, message, payload, data, size);
+    }
+}
+
+void EventLog::Write(LogLevel level, const char* message)
+{
+    Push(level, message, LogPayload::None, nullptr, 0);
+}
+
+void EventLog::WriteValue(LogLevel level, const char* message, uint64_t value)
+{
+    Push(level, message, LogPayload::Value, &value, sizeof(value));
+}
+
+void EventLog::WriteBytes(LogLevel level, const char* message, const uint8_t* data, size_t size)
+{
+    Push(level, message, LogPayload::Bytes, data, size);
+}
+
+void EventLog::WriteText(LogLevel level, const char* message, const char* text)
+{
+    Push(level, message, LogPayload::Text, text, std::strlen(text));
+}
+
+void EventLog::WriteText(LogLevel level, const char* message, const char* text, size_t length)
+{
+    Push(level, message, LogPayload::Text, text, length);
+}
+
+void EventLog::SetLevel(LogLevel level)
+{
+    Logger::Instance().m_level.store(static_cast<uint8_t>(level), std::memory_order_relaxed);
+}
+
+LogLevel EventLog::GetLevel()
+{
+    return static_cast<LogLevel>(Logger::Instance().m_level.load(std::memory_order_relaxed));
+}
+
+bool EventLog::IsEnabled(LogLevel level)
+{
+    return level != LogLevel::Off && level >= GetLevel();
+}
+
+void EventLog::SetRateLimit(uint32_t perSecond)
+{
+    Logger::Instance().m_rateLimit.store(perSecond, std::memory_order_relaxed);
+}
+
+void EventLog::SetOutput(Output output)
+{
+    Logger::Instance().SetOutput(std::move(output));
+}
+
+void EventLog::Flush()
+{
+    Logger::Instance().Flush();
+}
+
+LogStats EventLog::GetStats()
+{
+    return Logger::Instance().GetStats();
+}
+
+void EventLog::Shutdown()
+{
+    Logger::Instance().Shutdown();
+}
@@ -0,0 +1,79 @@
+#ifndef EVENT_LOG_H
+#define EVENT_LOG_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+enum class LogLevel : uint8_t
+{
+    Debug,
+    Info,
+    Warning,
+    Error,
+    Off
+};
+
+enum class LogPayload : uint8_t
+{
+    None,
+    Value,      // unsigned integer, shown in hex
+    Bytes,      // byte dump, shown in hex
+    Text
+};
+
+struct LogStats
+{
+    uint64_t written;       // records that reached the output
+    uint64_t dropped;       // lost because a thread's ring was full
+    uint64_t suppressed;    // held back by the rate limit
+};
+
+// Structured event log for callbacks and hot paths. Writing copies a binary
+// record (time, level, message pointer, raw payload) into a ring owned by the
+// calling thread: no locks, no formatting, no stream I/O. A drain thread
+// collects the rings, applies the level filter and a per-message rate limit,
+// formats the payloads and hands finished lines to the output.
+//
+// Messages must be string literals (or otherwise outlive the log): only the
+// pointer is recorded, and it also identifies the message for rate limiting.
+// Payloads are copied, longer ones cut to m_payloadCapacity bytes.
+namespace EventLog
+{
+    constexpr size_t m_payloadCapacity = 40;
+
+    void Write(LogLevel level, const char* message);
+    void WriteValue(LogLevel level, const char* message, uint64_t value);
+    void WriteBytes(LogLevel level, const char* message, const uint8_t* data, size_t size);
+    void WriteText(LogLevel level, const char* message, const char* text);
+    void WriteText(LogLevel level, const char* message, const char* text, size_t length);
+
+    // Records below the level are discarded by the writer; default Info.
+    void SetLevel(LogLevel level);
+    LogLevel GetLevel();
+    bool IsEnabled(LogLevel level);
+
+    // At most this many lines per message and second; 0 lifts the limit.
+    // The number held back is reported once the second is over.
+    void SetRateLimit(uint32_t perSecond);
+
+    // Called on the drain thread with each formatted line, without newline.
+    // Default (and when set empty) writes to stderr. Reset it before anything
+    // the output refers to goes away.
+    using Output = std::function<void(LogLevel level, const std::string& line)>;
+    void SetOutput(Output output);
+
+    // Waits until everything written before the call has been output.
+    void Flush();
+    LogStats GetStats();
+
+    // Outputs what is left and stops the drain thread; the next write starts
+    // it again. The log is never torn down by static destruction, which in a
+    // DLL runs under the loader lock where joining a thread can deadlock, so
+    // this is the last chance for pending records: BleEmulator calls it when
+    // destroyed, anything else should before unloading or exiting.
+    void Shutdown();
+}
+
+#endif // EVENT_LOG_H
@@ -0,0 +1,144 @@
+#include "GattReportSink.h"
+#include <cstring>
+
+GattReportSink::GattReportSink()
+    : m_bufferPool(m_transportBufferCount, [] { return Buffer(static_cast<uint32_t>(MaxHidReportSizeInBytes)); })
+{
+}
+
+void GattReportSink::Attach(HidReportId reportId, GattLocalCharacteristic const& characteristic)
+{
+    switch (reportId)
+    {
+    case HidReportId::Keyboard: m_keyboardReport = characteristic; break;
+    case HidReportId::ConsumerControl: m_consumerReport = characteristic; break;
+    case HidReportId::Mouse: m_mouseReport = characteristic; break;
+    case HidReportId::Digitizer: m_digitizerReport = characteristic; break;
+    }
+}
+
+GattLocalCharacteristic const& GattReportSink::CharacteristicFor(HidReportId reportId) const
+{
+    switch (reportId)
+    {
+    case HidReportId::Keyboard: return m_keyboardReport;
+    case HidReportId::ConsumerControl: return m_consumerReport;
+    case HidReportId::Digitizer: return m_digitizerReport;
+    default: return m_mouseReport;
+    }
+}
+
+bool GattReportSink::IsReady(HidReportId reportId) const
+{
+    auto const& characteristic = CharacteristicFor(reportId);
+    return characteristic && characteristic.SubscribedClients().Size() > 0;
+}
+
+void GattReportSink::SendReport(HidReportId reportId, const uint8_t* data, size_t size)
+{
+    auto const& characteristic = CharacteristicFor(reportId);
+    if (!characteristic)
+        return;
+
+    if (size > MaxHidReportSizeInBytes)
+        return;
+
+    // The report is copied straight into a recycled IBuffer instead of a fresh
+    // one from CryptographicBuffer; the lease returns it once the notify is done.
+    auto buffer = m_bufferPool.Acquire();
+    std::memcpy(buffer->data(), data, size);
+    buffer->Length(static_cast<uint32_t>(size));
+    characteristic.NotifyValueAsync(*buffer).get();
+}
+
+GattClientReportSink::GattClientReportSink(GattReportSink& characteristics, GattSubscribedClient const& client,
+    InputLatencyStats* latencyStats)
+    : m_characteristics(characteristics)
+    , m_client(client)
+    , m_latencyStats(latencyStats)
+{
+}
+
+GattClientReportSink::~GattClientReportSink()
+{
+    // Outstanding notifications still read from their leased buffers and call back into us.
+    std::unique_lock lock(m_windowMutex);
+    m_windowCondition.wait(lock, [this] { return m_inFlightCount == 0; });
+}
+
+void GattClientReportSink::Complete(size_t slot)
+{
+    // Notified under the lock: once the count reaches 0 the destructor may
+    // run, and it cannot get past the lock until this call is done with us.
+    std::scoped_lock lock(m_windowMutex);
+    m_inFlight[slot].buffer.Reset();
+    m_inFlight[slot].busy = false;
+    --m_inFlightCount;
+    m_windowCondition.notify_all();
+}
+
+void GattClientReportSink::SetSubscribed(HidReportId reportId, bool subscribed)
+{
+    m_subscribed[static_cast<size_t>(reportId) % HidReportIdCount].store(subscribed, std::memory_order_relaxed);
+}
+
+bool GattClientReportSink::IsReady(HidReportId reportId) const
+{
+    return m_subscribed[static_cast<size_t>(reportId) % HidReportIdCount].load(std::memory_order_relaxed);
+}
+
+void GattClientReportSink::SendReport(HidReportId reportId, const uint8_t* data, size_t size)
+{
+    auto const& characteristic = m_characteristics.CharacteristicFor(reportId);
+    if (!characteristic || size > MaxHidReportSizeInBytes)
+        return;
+
+    size_t slot = 0;
+    Buffer buffer{ nullptr };
+    {
+        std::unique_lock lock(m_windowMutex);
+        m_windowCondition.wait(lock, [this] { return m_inFlightCount < m_inFlightWindow; });
+        while (m_inFlight[slot].busy)
+            ++slot;
+
+        auto& notify = m_inFlight[slot];
+        notify.busy = true;
+        notify.buffer = m_characteristics.AcquireBuffer();
+        buffer = *notify.buffer;
+        ++m_inFlightCount;
+    }
+
+    std::memcpy(buffer.data(), data, size);
+    buffer.Length(static_cast<uint32_t>(size));
+
+    uint64_t origin = ReportOrigin::Current();
+    uint64_t start = ReportOrigin::Now();
+    try
+    {
+        characteristic.NotifyValueAsync(buffer, m_client).Completed(
+            [this, slot, reportId, origin, start](auto const& operation, Windows::Foundation::AsyncStatus status) {
+                uint64_t end = ReportOrigin::Now();
+                // Only a notification the central took counts as delivered.
+                bool delivered = status == Windows::Foundation::AsyncStatus::Completed &&
+                    operation.GetResults().Status() == GattCommunicationStatus::Success;
+                if (!delivered)
+                    m_failedCount.fetch_add(1, std::memory_order_relaxed);
+                if (m_latencyStats)
+                {
+                    if (delivered)
+                        m_latencyStats->RecordTransmit(reportId, origin, start, end);
+                    else
+                        m_latencyStats->RecordTransmitFailure(reportId);
+                }
+                Complete(slot);
+            });
+    }
+    catch (winrt::hresult_error const&)
+    {
+        // The central went away; the fan-out drops it on the next subscription change.
+        m_failedCount.fetch_add(1, std::memory_order_relaxed);
+        if (m_latencyStats)
+            m_latencyStats->RecordTransmitFailure(reportId);
+        Complete(slot);
+    }
+}
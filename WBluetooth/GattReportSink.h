@@ -0,0 +1,90 @@
+#ifndef GATT_REPORT_SINK_H
+#define GATT_REPORT_SINK_H
+
+#include "HidReportSink.h"
+#include "HidReports.h"
+#include "InputLatency.h"
+#include "ReportBufferPool.h"
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <winrt/Windows.Devices.Bluetooth.GenericAttributeProfile.h>
+#include <winrt/Windows.Foundation.Collections.h>
+#include <winrt/Windows.Storage.Streams.h>
+
+using namespace winrt;
+using namespace Windows::Devices::Bluetooth::GenericAttributeProfile;
+using namespace Windows::Storage::Streams;
+
+// Sends reports as GATT notifications on the HID Report characteristics.
+class GattReportSink : public HidReportSink
+{
+public:
+    static constexpr size_t m_transportBufferCount = 8;
+
+    GattReportSink();
+
+    void Attach(HidReportId reportId, GattLocalCharacteristic const& characteristic);
+
+    bool IsReady(HidReportId reportId) const override;
+    void SendReport(HidReportId reportId, const uint8_t* data, size_t size) override;
+
+    uint64_t GetTransportAllocationCount() const { return m_bufferPool.GetAllocationCount(); }
+
+    GattLocalCharacteristic const& CharacteristicFor(HidReportId reportId) const;
+    ReportBufferPool<Buffer>::Lease AcquireBuffer() { return m_bufferPool.Acquire(); }
+
+private:
+    GattLocalCharacteristic m_keyboardReport{ nullptr };
+    GattLocalCharacteristic m_consumerReport{ nullptr };
+    GattLocalCharacteristic m_mouseReport{ nullptr };
+    GattLocalCharacteristic m_digitizerReport{ nullptr };
+
+    ReportBufferPool<Buffer> m_bufferPool;
+};
+
+// Sends reports as notifications to a single subscribed central, for use as a
+// ReportFanOut client transport. Up to m_inFlightWindow notifications are left
+// outstanding; only a full window makes SendReport() wait for one to complete.
+// Completions are timed into the latency stats, if given.
+class GattClientReportSink : public HidReportSink
+{
+public:
+    static constexpr size_t m_inFlightWindow = 4;
+
+    GattClientReportSink(GattReportSink& characteristics, GattSubscribedClient const& client,
+        InputLatencyStats* latencyStats = nullptr);
+    ~GattClientReportSink();
+
+    // Which reports the central subscribed to; kept up to date by the owner.
+    void SetSubscribed(HidReportId reportId, bool subscribed);
+
+    bool IsReady(HidReportId reportId) const override;
+    void SendReport(HidReportId reportId, const uint8_t* data, size_t size) override;
+
+    // Notifications that failed, were cancelled or were not acknowledged.
+    uint64_t GetFailedCount() const { return m_failedCount.load(std::memory_order_relaxed); }
+
+private:
+    struct InFlightNotify {
+        bool busy = false;
+        ReportBufferPool<Buffer>::Lease buffer;
+    };
+
+    void Complete(size_t slot);
+
+    GattReportSink& m_characteristics;
+    GattSubscribedClient m_client;
+    InputLatencyStats* m_latencyStats;
+    std::array<std::atomic<bool>, HidReportIdCount> m_subscribed{};
+    std::atomic<uint64_t> m_failedCount{ 0 };
+
+    // Slots are freed by completion handlers on WinRT threads.
+    std::mutex m_windowMutex;
+    std::condition_variable m_windowCondition;
+    std::array<InFlightNotify, m_inFlightWindow> m_inFlight;
+    size_t m_inFlightCount = 0;
+};
+
+#endif // GATT_REPORT_SINK_H
@@ -0,0 +1,236 @@
+#ifndef HID_DESCRIPTOR_H
+#define HID_DESCRIPTOR_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Compile-time HID report descriptor builder.
+//
+// A report map is written as a list of items and encoded by Build() into a
+// constexpr byte array, so the GATT Report Map value costs no runtime work.
+// The same constexpr walk the host does is available as InputReportBits() and
+// FindInputField(), which lets the packed report structs in HidReports.h be
+// checked field by field against the map with static_assert.
+namespace HidDescriptor
+{
+    namespace Page
+    {
+        constexpr uint16_t GenericDesktop = 0x01;
+        constexpr uint16_t Keyboard = 0x07;
+        constexpr uint16_t Button = 0x09;
+        constexpr uint16_t Consumer = 0x0C;
+        constexpr uint16_t Digitizer = 0x0D;
+    }
+
+    namespace UsageId
+    {
+        // Generic Desktop
+        constexpr uint16_t Pointer = 0x01;
+        constexpr uint16_t Mouse = 0x02;
+        constexpr uint16_t Keyboard = 0x06;
+        constexpr uint16_t X = 0x30;
+        constexpr uint16_t Y = 0x31;
+        constexpr uint16_t Wheel = 0x38;
+        // Consumer
+        constexpr uint16_t ConsumerControl = 0x01;
+        constexpr uint16_t ACPan = 0x0238;
+        // Digitizer
+        constexpr uint16_t TouchScreen = 0x04;
+        constexpr uint16_t Finger = 0x22;
+        constexpr uint16_t InRange = 0x32;
+        constexpr uint16_t TipSwitch = 0x42;
+    }
+
+    namespace CollectionType
+    {
+        constexpr uint8_t Physical = 0x00;
+        constexpr uint8_t Application = 0x01;
+        constexpr uint8_t Logical = 0x02;
+    }
+
+    // Bits of an Input main item.
+    constexpr uint8_t Data = 0x00;
+    constexpr uint8_t Constant = 0x01;
+    constexpr uint8_t Array = 0x00;
+    constexpr uint8_t Variable = 0x02;
+    constexpr uint8_t Absolute = 0x00;
+    constexpr uint8_t Relative = 0x04;
+
+    // Item prefixes with the size bits clear.
+    enum class Tag : uint8_t
+    {
+        Input = 0x80,
+        Collection = 0xA0,
+        EndCollection = 0xC0,
+        UsagePage = 0x04,
+        LogicalMinimum = 0x14,
+        LogicalMaximum = 0x24,
+        ReportSize = 0x74,
+        ReportId = 0x84,
+        ReportCount = 0x94,
+        Usage = 0x08,
+        UsageMinimum = 0x18,
+        UsageMaximum = 0x28
+    };
+
+    // One short item: the data is stored little-endian in the fewest bytes
+    // that hold it (signed items keep their sign bit).
+    struct Item
+    {
+        uint8_t prefix;
+        uint8_t size;
+        uint32_t data;
+    };
+
+    constexpr uint8_t SizeCode(uint8_t size) { return size == 4 ? 3 : size; }
+
+    constexpr Item UnsignedItem(Tag tag, uint32_t value)
+    {
+        uint8_t size = value <= 0xFF ? 1 : value <= 0xFFFF ? 2 : 4;
+        return { static_cast<uint8_t>(static_cast<uint8_t>(tag) | SizeCode(size)), size, value };
+    }
+
+    constexpr Item SignedItem(Tag tag, int32_t value)
+    {
+        uint8_t size = (value >= -128 && value <= 127) ? 1 : (value >= -32768 && value <= 32767) ? 2 : 4;
+        return { static_cast<uint8_t>(static_cast<uint8_t>(tag) | SizeCode(size)), size, static_cast<uint32_t>(value) };
+    }
+
+    constexpr Item UsagePage(uint16_t page) { return UnsignedItem(Tag::UsagePage, page); }
+    constexpr Item Usage(uint16_t usage) { return UnsignedItem(Tag::Usage, usage); }
+    constexpr Item UsageMinimum(uint16_t usage) { return UnsignedItem(Tag::UsageMinimum, usage); }
+    constexpr Item UsageMaximum(uint16_t usage) { return UnsignedItem(Tag::UsageMaximum, usage); }
+    constexpr Item LogicalMinimum(int32_t value) { return SignedItem(Tag::LogicalMinimum, value); }
+    constexpr Item LogicalMaximum(int32_t value) { return SignedItem(Tag::LogicalMaximum, value); }
+    constexpr Item ReportSize(uint8_t bits) { return UnsignedItem(Tag::ReportSize, bits); }
+    constexpr Item ReportCount(uint8_t count) { return UnsignedItem(Tag::ReportCount, count); }
+    constexpr Item ReportId(uint8_t id) { return UnsignedItem(Tag::ReportId, id); }
+    constexpr Item Input(uint8_t flags) { return UnsignedItem(Tag::Input, flags); }
+    constexpr Item Collection(uint8_t type) { return UnsignedItem(Tag::Collection, type); }
+    constexpr Item EndCollection() { return { static_cast<uint8_t>(Tag::EndCollection), 0, 0 }; }
+
+    template <size_t Capacity>
+    struct ReportMap
+    {
+        std::array<uint8_t, Capacity> bytes{};
+        size_t size = 0;
+
+        constexpr const uint8_t* begin() const { return bytes.data(); }
+        constexpr const uint8_t* end() const { return bytes.data() + size; }
+    };
+
+    template <size_t N>
+    constexpr ReportMap<N * 5> Build(const Item (&items)[N])
+    {
+        ReportMap<N * 5> map{};
+        for (size_t i = 0; i < N; ++i)
+        {
+            map.bytes[map.size++] = items[i].prefix;
+            for (uint8_t b = 0; b < items[i].size; ++b)
+                map.bytes[map.size++] = static_cast<uint8_t>(items[i].data >> (8 * b));
+        }
+        return map;
+    }
+
+    // Where a usage sits in an input report.
+    struct Field
+    {
+        bool found;
+        uint32_t bitOffset;
+        uint32_t bitSize;
+        uint32_t count;     // elements of an array field, 1 for a variable
+    };
+
+    // Walks the map like a host parser and reports the input field carrying
+    // usagePage/usage in report reportId, or the total size of that report when
+    // usagePage is 0. Usage Push/Pop, long items and extended usages are not used
+    // by our maps and not understood here.
+    template <size_t Capacity>
+    constexpr Field WalkInput(const ReportMap<Capacity>& map, uint8_t reportId, uint16_t usagePage, uint16_t usage)
+    {
+        constexpr size_t maxLocalUsages = 16;
+        uint32_t page = 0, reportSize = 0, reportCount = 0, currentId = 0, offset = 0;
+        uint32_t usages[maxLocalUsages] = {};
+        size_t usageCount = 0;
+        uint32_t usageMin = 0, usageMax = 0;
+        bool hasRange = false;
+
+        for (size_t i = 0; i < map.size;)
+        {
+            uint8_t prefix = map.bytes[i++];
+            uint8_t size = (prefix & 0x03) == 3 ? 4 : (prefix & 0x03);
+            uint32_t data = 0;
+            for (uint8_t b = 0; b < size && i < map.size; ++b)
+                data |= static_cast<uint32_t>(map.bytes[i++]) << (8 * b);
+
+            switch (static_cast<Tag>(prefix & 0xFC))
+            {
+            case Tag::UsagePage: page = data; break;
+            case Tag::ReportSize: reportSize = data; break;
+            case Tag::ReportCount: reportCount = data; break;
+            case Tag::ReportId: currentId = data; break;
+            case Tag::Usage:
+                if (usageCount < maxLocalUsages)
+                    usages[usageCount++] = data;
+                break;
+            case Tag::UsageMinimum: usageMin = data; hasRange = true; break;
+            case Tag::UsageMaximum: usageMax = data; hasRange = true; break;
+            case Tag::Input:
+                if (currentId == reportId)
+                {
+                    if (usagePage != 0 && page == usagePage && (data & Constant) == 0)
+                    {
+                        if ((data & Variable) == 0)
+                        {
+                            // Array: every element can hold any usage in the range.
+                            bool listed = hasRange && usage >= usageMin && usage <= usageMax;
+                            for (size_t u = 0; u < usageCount; ++u)
+                                listed = listed || usages[u] == usage;
+                            if (listed)
+                                return { true, offset, reportSize, reportCount };
+                        }
+                        else
+                        {
+                            for (uint32_t element = 0; element < reportCount; ++element)
+                            {
+                                uint32_t elementUsage = element < usageCount ? usages[element]
+                                    : hasRange ? usageMin + element : 0;
+                                if (hasRange && usageCount == 0 && elementUsage > usageMax)
+                                    elementUsage = 0;
+                                if (elementUsage == usage)
+                                    return { true, offset + element * reportSize, reportSize, 1 };
+                            }
+                        }
+                    }
+                    offset += reportSize * reportCount;
+                }
+                usageCount = 0;
+                hasRange = false;
+                break;
+            case Tag::Collection:
+            case Tag::EndCollection:
+                usageCount = 0;
+                hasRange = false;
+                break;
+            default:
+                break;
+            }
+        }
+        return { usagePage == 0, 0, offset, 1 };
+    }
+
+    template <size_t Capacity>
+    constexpr uint32_t InputReportBits(const ReportMap<Capacity>& map, uint8_t reportId)
+    {
+        return WalkInput(map, reportId, 0, 0).bitSize;
+    }
+
+    template <size_t Capacity>
+    constexpr Field FindInputField(const ReportMap<Capacity>& map, uint8_t reportId, uint16_t usagePage, uint16_t usage)
+    {
+        return WalkInput(map, reportId, usagePage, usage);
+    }
+}
+
+#endif // HID_DESCRIPTOR_H
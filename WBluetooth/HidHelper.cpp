@@ -1,109 +1,192 @@
 #include "HidHelper.h"
+#include "EventLog.h"
+#include <array>
+#include <atomic>
 
-uint8_t HidHelper::GetHidUsageFromPs2Set1(uint32_t scanCode)
+namespace
 {
-    switch (scanCode)
+    struct ScanCodeMapping
     {
-    case 0x29: return 0x35;  // Key location 1  ( ~ ` )
-    case 0x02: return 0x1E;  // Key location 2  ( ! 1 )
-    case 0x03: return 0x1F;  // Key location 3  ( @ 2 )
-    case 0x04: return 0x20;  // Key location 4  ( # 3 )
-    case 0x05: return 0x21;  // Key location 5  ( $ 4 )
-    case 0x06: return 0x22;  // Key location 6  ( % 5 )
-    case 0x07: return 0x23;  // Key location 7  ( ^ 6 )
-    case 0x08: return 0x24;  // Key location 8  ( & 7 )
-    case 0x09: return 0x25;  // Key location 9  ( * 8 )
-    case 0x0A: return 0x26;  // Key location 10 ( ( 9 )
-    case 0x0B: return 0x27;  // Key location 11 ( ) 0 )
-    case 0x0C: return 0x2D;  // Key location 12 ( _ - )
-    case 0x0D: return 0x2E;  // Key location 13 ( + = )
-    case 0x0E: return 0x2A;  // Key location 15 ( Backspace )
-    case 0x0F: return 0x2B;  // Key location 16 ( Tab )
-    case 0x10: return 0x14;  // Key location 17 ( Q )
-    case 0x11: return 0x1A;  // Key location 18 ( W )
-    case 0x12: return 0x08;  // Key location 19 ( E )
-    case 0x13: return 0x15;  // Key location 20 ( R )
-    case 0x14: return 0x17;  // Key location 21 ( T )
-    case 0x15: return 0x1C;  // Key location 22 ( Y )
-    case 0x16: return 0x18;  // Key location 23 ( U )
-    case 0x17: return 0x0C;  // Key location 24 ( I )
-    case 0x18: return 0x12;  // Key location 25 ( O )
-    case 0x19: return 0x13;  // Key location 26 ( P )
-    case 0x1A: return 0x2F;  // Key location 27 ( { [ )
-    case 0x1B: return 0x30;  // Key location 28 ( } ] )
-    case 0x2B: return 0x31;  // Key location 29* ( | \ )
-    case 0x3A: return 0x39;  // Key location 30 ( Caps Lock )
-    case 0x1E: return 0x04;  // Key location 31 ( A )
-    case 0x1F: return 0x16;  // Key location 32 ( S )
-    case 0x20: return 0x07;  // Key location 33 ( D )
-    case 0x21: return 0x09;  // Key location 34 ( F )
-    case 0x22: return 0x0A;  // Key location 35 ( G )
-    case 0x23: return 0x0B;  // Key location 36 ( H )
-    case 0x24: return 0x0D;  // Key location 37 ( J )
-    case 0x25: return 0x0E;  // Key location 38 ( K )
-    case 0x26: return 0x0F;  // Key location 39 ( L )
-    case 0x27: return 0x33;  // Key location 40 ( : ; )
-    case 0x28: return 0x34;  // Key location 41 ( “ ‘ )
-    case 0x1C: return 0x28;  // Key location 43 ( Enter )
-    case 0x2A: return 0xE1;  // Key location 44 ( L SHIFT )
-    case 0x56: return 0x64;  // Key location 45 ( NONE ) **
-    case 0x2C: return 0x1D;  // Key location 46 ( Z )
-    case 0x2D: return 0x1B;  // Key location 47 ( X )
-    case 0x2E: return 0x06;  // Key location 48 ( C )
-    case 0x2F: return 0x19;  // Key location 49 ( V )
-    case 0x30: return 0x05;  // Key location 50 ( B )
-    case 0x31: return 0x11;  // Key location 51 ( N )
-    case 0x32: return 0x10;  // Key location 52 ( M )
-    case 0x33: return 0x36;  // Key location 53 ( < , )
-    case 0x34: return 0x37;  // Key location 54 ( > . )
-    case 0x35: return 0x38;  // Key location 55 ( ? / )
-    case 0x73: return 0x87;  // Key location 56 ( NONE ) ***
-    case 0x36: return 0xE5;  // Key location 57 ( R SHIFT )
-    case 0x1D: return 0xE0;  // Key location 58 ( L CTRL )
-    case 0xE05B: return 0xE3; // Key location 59 ( L WIN )
-    case 0x38: return 0xE2; // Key location 60 ( L ALT )
-    case 0x39: return 0x2C; // Key location 61 ( Space Bar )
-    case 0xE038: return 0xE6; // Key location 62 ( R ALT )
-    case 0xE05C: return 0xE7; // Key location 63 ( R WIN )
-    case 0xE01D: return 0xE4; // Key location 64 ( R CTRL )
-    case 0xE05D: return 0x65; // Key location 65 ( APP )
-
-    case 0xE048: return 0x52; // ↑ Up
-    case 0xE050: return 0x51; // ↓ Down
-    case 0xE04B: return 0x50; // ← Left
-    case 0xE04D: return 0x4F; // → Right
-        // 第一排功能键
-    case 0x01: return 0x29;  // Esc
-    case 0x3B: return 0x3A;  // F1
-    case 0x3C: return 0x3B;  // F2
-    case 0x3D: return 0x3C;  // F3
-    case 0x3E: return 0x3D;  // F4
-    case 0x3F: return 0x3E;  // F5
-    case 0x40: return 0x3F;  // F6
-    case 0x41: return 0x40;  // F7
-    case 0x42: return 0x41;  // F8
-    case 0x43: return 0x42;  // F9
-    case 0x44: return 0x43;  // F10
-    case 0x57: return 0x44;  // F11
-    case 0x58: return 0x45;  // F12
+        uint32_t scanCode;
+        uint8_t usage;
+    };
 
+    // PS/2 scan code set 1 → HID keyboard/keypad usage.
+    constexpr ScanCodeMapping s_ps2Set1Mappings[] = {
+        { 0x29, 0x35 },         // Key location 1  ( ~ ` )
+        { 0x02, 0x1E },         // Key location 2  ( ! 1 )
+        { 0x03, 0x1F },         // Key location 3  ( @ 2 )
+        { 0x04, 0x20 },         // Key location 4  ( # 3 )
+        { 0x05, 0x21 },         // Key location 5  ( $ 4 )
+        { 0x06, 0x22 },         // Key location 6  ( % 5 )
+        { 0x07, 0x23 },         // Key location 7  ( ^ 6 )
+        { 0x08, 0x24 },         // Key location 8  ( & 7 )
+        { 0x09, 0x25 },         // Key location 9  ( * 8 )
+        { 0x0A, 0x26 },         // Key location 10 ( ( 9 )
+        { 0x0B, 0x27 },         // Key location 11 ( ) 0 )
+        { 0x0C, 0x2D },         // Key location 12 ( _ - )
+        { 0x0D, 0x2E },         // Key location 13 ( + = )
+        { 0x0E, 0x2A },         // Key location 15 ( Backspace )
+        { 0x0F, 0x2B },         // Key location 16 ( Tab )
+        { 0x10, 0x14 },         // Key location 17 ( Q )
+        { 0x11, 0x1A },         // Key location 18 ( W )
+        { 0x12, 0x08 },         // Key location 19 ( E )
+        { 0x13, 0x15 },         // Key location 20 ( R )
+        { 0x14, 0x17 },         // Key location 21 ( T )
+        { 0x15, 0x1C },         // Key location 22 ( Y )
+        { 0x16, 0x18 },         // Key location 23 ( U )
+        { 0x17, 0x0C },         // Key location 24 ( I )
+        { 0x18, 0x12 },         // Key location 25 ( O )
+        { 0x19, 0x13 },         // Key location 26 ( P )
+        { 0x1A, 0x2F },         // Key location 27 ( { [ )
+        { 0x1B, 0x30 },         // Key location 28 ( } ] )
+        { 0x2B, 0x31 },         // Key location 29* ( | \ )
+        { 0x3A, 0x39 },         // Key location 30 ( Caps Lock )
+        { 0x1E, 0x04 },         // Key location 31 ( A )
+        { 0x1F, 0x16 },         // Key location 32 ( S )
+        { 0x20, 0x07 },         // Key location 33 ( D )
+        { 0x21, 0x09 },         // Key location 34 ( F )
+        { 0x22, 0x0A },         // Key location 35 ( G )
+        { 0x23, 0x0B },         // Key location 36 ( H )
+        { 0x24, 0x0D },         // Key location 37 ( J )
+        { 0x25, 0x0E },         // Key location 38 ( K )
+        { 0x26, 0x0F },         // Key location 39 ( L )
+        { 0x27, 0x33 },         // Key location 40 ( : ; )
+        { 0x28, 0x34 },         // Key location 41 ( “ ‘ )
+        { 0x1C, 0x28 },         // Key location 43 ( Enter )
+        { 0x2A, 0xE1 },         // Key location 44 ( L SHIFT )
+        { 0x56, 0x64 },         // Key location 45 ( NONE ) **
+        { 0x2C, 0x1D },         // Key location 46 ( Z )
+        { 0x2D, 0x1B },         // Key location 47 ( X )
+        { 0x2E, 0x06 },         // Key location 48 ( C )
+        { 0x2F, 0x19 },         // Key location 49 ( V )
+        { 0x30, 0x05 },         // Key location 50 ( B )
+        { 0x31, 0x11 },         // Key location 51 ( N )
+        { 0x32, 0x10 },         // Key location 52 ( M )
+        { 0x33, 0x36 },         // Key location 53 ( < , )
+        { 0x34, 0x37 },         // Key location 54 ( > . )
+        { 0x35, 0x38 },         // Key location 55 ( ? / )
+        { 0x73, 0x87 },         // Key location 56 ( NONE ) ***
+        { 0x36, 0xE5 },         // Key location 57 ( R SHIFT )
+        { 0x1D, 0xE0 },         // Key location 58 ( L CTRL )
+        { 0xE05B, 0xE3 },       // Key location 59 ( L WIN )
+        { 0x38, 0xE2 },         // Key location 60 ( L ALT )
+        { 0x39, 0x2C },         // Key location 61 ( Space Bar )
+        { 0xE038, 0xE6 },       // Key location 62 ( R ALT )
+        { 0xE05C, 0xE7 },       // Key location 63 ( R WIN )
+        { 0xE01D, 0xE4 },       // Key location 64 ( R CTRL )
+        { 0xE05D, 0x65 },       // Key location 65 ( APP )
+        { 0xE048, 0x52 },       // ↑ Up
+        { 0xE050, 0x51 },       // ↓ Down
+        { 0xE04B, 0x50 },       // ← Left
+        { 0xE04D, 0x4F },       // → Right
+        // 第一排功能键
+        { 0x01, 0x29 },         // Esc
+        { 0x3B, 0x3A },         // F1
+        { 0x3C, 0x3B },         // F2
+        { 0x3D, 0x3C },         // F3
+        { 0x3E, 0x3D },         // F4
+        { 0x3F, 0x3E },         // F5
+        { 0x40, 0x3F },         // F6
+        { 0x41, 0x40 },         // F7
+        { 0x42, 0x41 },         // F8
+        { 0x43, 0x42 },         // F9
+        { 0x44, 0x43 },         // F10
+        { 0x57, 0x44 },         // F11
+        { 0x58, 0x45 },         // F12
         // 控制区扩展键
-    case 0xE052: return 0x49; // Insert
-    case 0xE053: return 0x4C; // Delete
-    case 0xE047: return 0x4A; // Home
-    case 0xE04F: return 0x4D; // End
-    case 0xE049: return 0x4B; // Page Up
-    case 0xE051: return 0x4E; // Page Down
-    case 0xE037: return 0x46; // Print Screen
-    case 0x46:    return 0x47; // Scroll Lock
-    case 0xE11D45: return 0x48; // Pause/Break
-
-    default:
-        std::cerr << "[HidHelper] Unsupported scan code: 0x" << std::hex << scanCode << std::endl;
+        { 0xE052, 0x49 },       // Insert
+        { 0xE053, 0x4C },       // Delete
+        { 0xE047, 0x4A },       // Home
+        { 0xE04F, 0x4D },       // End
+        { 0xE049, 0x4B },       // Page Up
+        { 0xE051, 0x4E },       // Page Down
+        { 0xE037, 0x46 },       // Print Screen
+        { 0x46, 0x47 },         // Scroll Lock
+        { 0xE11D45, 0x48 },     // Pause/Break
+    };
+
+    constexpr uint32_t s_e0Prefix = 0xE000;
+    constexpr uint32_t s_pauseScanCode = 0xE11D45;
+    constexpr uint8_t s_pauseUsage = 0x48;
+
+    struct ScanCodeTables
+    {
+        std::array<uint8_t, 256> singleByte{};   // 0x00..0xFF
+        std::array<uint8_t, 256> e0Page{};       // 0xE000..0xE0FF
+        std::array<uint32_t, 256> reverse{};     // HID usage → set 1
+    };
+
+    constexpr ScanCodeTables BuildScanCodeTables()
+    {
+        ScanCodeTables tables{};
+        for (const auto& mapping : s_ps2Set1Mappings)
+        {
+            if (mapping.scanCode <= 0xFF)
+                tables.singleByte[mapping.scanCode] = mapping.usage;
+            else if ((mapping.scanCode & 0xFFFFFF00) == s_e0Prefix)
+                tables.e0Page[mapping.scanCode & 0xFF] = mapping.usage;
+
+            if (tables.reverse[mapping.usage] == 0)
+                tables.reverse[mapping.usage] = mapping.scanCode;
+        }
+        return tables;
+    }
+
+    constexpr ScanCodeTables s_tables = BuildScanCodeTables();
+
+    static_assert(s_tables.singleByte[0x1E] == 0x04, "A");
+    static_assert(s_tables.e0Page[0x48] == 0x52, "Up");
+    static_assert(s_tables.reverse[0x04] == 0x1E, "A");
+    static_assert(s_tables.reverse[s_pauseUsage] == s_pauseScanCode, "Pause/Break");
+
+    std::atomic<uint64_t> s_unknownScanCodeCount{ 0 };
+
+    inline uint8_t LookupUsage(uint32_t scanCode)
+    {
+        if (scanCode <= 0xFF)
+            return s_tables.singleByte[scanCode];
+        if ((scanCode & 0xFFFFFF00) == s_e0Prefix)
+            return s_tables.e0Page[scanCode & 0xFF];
+        if (scanCode == s_pauseScanCode)
+            return s_pauseUsage;
         return 0x00;
     }
 }
 
+uint8_t HidHelper::GetHidUsageFromPs2Set1(uint32_t scanCode)
+{
+    uint8_t usage = LookupUsage(scanCode);
+    if (usage == 0x00)
+        s_unknownScanCodeCount.fetch_add(1, std::memory_order_relaxed);
+    return usage;
+}
+
+uint32_t HidHelper::GetPs2Set1FromHidUsage(uint8_t usageCode)
+{
+    return s_tables.reverse[usageCode];
+}
+
+size_t HidHelper::GetHidUsagesFromPs2Set1(const uint32_t* scanCodes, size_t count, uint8_t* usages)
+{
+    size_t misses = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint8_t usage = LookupUsage(scanCodes[i]);
+        usages[i] = usage;
+        misses += (usage == 0x00);
+    }
+
+    if (misses > 0)
+        s_unknownScanCodeCount.fetch_add(misses, std::memory_order_relaxed);
+    return misses;
+}
+
+uint64_t HidHelper::GetUnknownScanCodeCount()
+{
+    return s_unknownScanCodeCount.load(std::memory_order_relaxed);
+}
+
 bool HidHelper::IsModifierKey(uint8_t code)
 {
     return code >= 0xE0 && code <= 0xE7;
@@ -113,7 +196,7 @@ uint8_t HidHelper::GetFlagOfModifierKey(uint8_t code)
 {
     if (!IsModifierKey(code))
     {
-        std::cerr << "[HidHelper] Not a modifier key: 0x" << std::hex << static_cast<int>(code) << std::endl;
+        EventLog::WriteValue(LogLevel::Warning, "[HidHelper] Not a modifier key:", code);
         return 0x00;
     }
     return 1 << (code - 0xE0);
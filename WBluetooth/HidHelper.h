@@ -2,10 +2,7 @@
 #define HID_HELPER_H
 
 #include <cstdint>
-#include <set>
-#include <vector>
-#include <array>
-#include <iostream>
+#include <cstddef>
 
 enum class KeyEvent
 {
@@ -16,7 +13,13 @@ enum class KeyEvent
 class HidHelper
 {
 public:
+    // Table lookups; unknown codes yield 0x00 and bump the unknown-code counter.
     static uint8_t GetHidUsageFromPs2Set1(uint32_t scanCode);
+    static uint32_t GetPs2Set1FromHidUsage(uint8_t usageCode);
+    // Translates count scan codes into usages, returns how many were unknown.
+    static size_t GetHidUsagesFromPs2Set1(const uint32_t* scanCodes, size_t count, uint8_t* usages);
+    static uint64_t GetUnknownScanCodeCount();
+
     static bool IsModifierKey(uint8_t usageCode);
     static uint8_t GetFlagOfModifierKey(uint8_t usageCode);
     static bool IsFunctionKey(uint8_t usageCode);
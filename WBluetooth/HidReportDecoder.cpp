@@ -0,0 +1,231 @@
+#include "HidReportDecoder.h"
+#include <algorithm>
+#include <map>
+
+namespace
+{
+    struct GlobalState
+    {
+        uint16_t usagePage = 0;
+        int32_t logicalMinimum = 0;
+        int32_t logicalMaximum = 0;
+        uint32_t reportSize = 0;
+        uint32_t reportCount = 0;
+        uint8_t reportId = 0;
+    };
+
+    int32_t SignExtend(uint32_t value, size_t size)
+    {
+        switch (size)
+        {
+        case 1: return static_cast<int8_t>(value);
+        case 2: return static_cast<int16_t>(value);
+        default: return static_cast<int32_t>(value);
+        }
+    }
+}
+
+uint32_t HidReportDecoder::ExtractBits(const uint8_t* data, uint32_t bitOffset, uint8_t bitSize)
+{
+    const uint8_t* bytes = data + bitOffset / 8;
+    if ((bitOffset & 7) == 0)
+    {
+        switch (bitSize)
+        {
+        case 8: return bytes[0];
+        case 16: return bytes[0] | (static_cast<uint32_t>(bytes[1]) << 8);
+        case 32: return bytes[0] | (static_cast<uint32_t>(bytes[1]) << 8) |
+            (static_cast<uint32_t>(bytes[2]) << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+        default: break;
+        }
+    }
+
+    uint32_t shift = bitOffset & 7;
+    uint32_t byteCount = (shift + bitSize + 7) / 8;
+    uint64_t window = 0;
+    for (uint32_t i = 0; i < byteCount; ++i)
+        window |= static_cast<uint64_t>(bytes[i]) << (8 * i);
+    uint64_t mask = bitSize >= 32 ? 0xFFFFFFFFull : ((1ull << bitSize) - 1);
+    return static_cast<uint32_t>((window >> shift) & mask);
+}
+
+bool HidReportDecoder::Parse(const uint8_t* reportMap, size_t size)
+{
+    GlobalState global;
+    std::vector<GlobalState> globalStack;
+    std::vector<uint32_t> usages;
+    uint32_t usageMinimum = 0, usageMaximum = 0;
+    bool hasUsageRange = false;
+    int collectionDepth = 0;
+
+    std::map<uint8_t, std::vector<Element>> parsed;
+    std::map<uint8_t, uint32_t> reportBits;
+
+    auto clearLocals = [&] {
+        usages.clear();
+        hasUsageRange = false;
+        usageMinimum = usageMaximum = 0;
+    };
+
+    for (size_t i = 0; i < size;)
+    {
+        uint8_t prefix = reportMap[i++];
+        if (prefix == 0xFE)
+        {
+            // Long item: data size, long tag, data. None are defined for input.
+            if (i + 2 > size || i + 2 + reportMap[i] > size)
+                return false;
+            i += 2 + reportMap[i];
+            continue;
+        }
+
+        size_t dataSize = (prefix & 0x03) == 3 ? 4 : (prefix & 0x03);
+        if (i + dataSize > size)
+            return false;
+        uint32_t data = 0;
+        for (size_t b = 0; b < dataSize; ++b)
+            data |= static_cast<uint32_t>(reportMap[i + b]) << (8 * b);
+        i += dataSize;
+
+        uint8_t type = (prefix >> 2) & 0x03;
+        uint8_t tag = prefix >> 4;
+
+        if (type == 0) // Main
+        {
+            switch (tag)
+            {
+            case 0x8: // Input
+            {
+                uint32_t& offset = reportBits[global.reportId];
+                bool constant = (data & 0x01) != 0;
+                bool variable = (data & 0x02) != 0;
+                bool relative = (data & 0x04) != 0;
+
+                // A logical maximum that only looks negative because of its
+                // encoding is unsigned when the minimum is not below zero.
+                int32_t logicalMaximum = global.logicalMaximum;
+                if (global.logicalMinimum >= 0 && logicalMaximum < 0)
+                    logicalMaximum = static_cast<int32_t>(static_cast<uint32_t>(logicalMaximum) & 0xFFFF);
+
+                auto& elements = parsed[global.reportId];
+                for (uint32_t element = 0; !constant && global.reportSize > 0 && element < global.reportCount; ++element)
+                {
+                    uint32_t usage = 0;
+                    if (!variable)
+                        usage = hasUsageRange ? usageMinimum : (usages.empty() ? 0 : usages.front());
+                    else if (element < usages.size())
+                        usage = usages[element];
+                    else if (hasUsageRange)
+                        usage = std::min(usageMinimum + element, usageMaximum);
+                    else if (!usages.empty())
+                        usage = usages.back();
+
+                    Element parsedElement{};
+                    parsedElement.bitOffset = offset + element * global.reportSize;
+                    parsedElement.bitSize = static_cast<uint8_t>(std::min<uint32_t>(global.reportSize, 32));
+                    parsedElement.isArray = !variable;
+                    parsedElement.isSigned = global.logicalMinimum < 0;
+                    parsedElement.relative = relative;
+                    // Four-byte usages carry their own page in the high half.
+                    parsedElement.usagePage = usage > 0xFFFF ? static_cast<uint16_t>(usage >> 16) : global.usagePage;
+                    parsedElement.usage = static_cast<uint16_t>(usage);
+                    parsedElement.logicalMinimum = global.logicalMinimum;
+                    parsedElement.logicalMaximum = logicalMaximum;
+                    elements.push_back(parsedElement);
+                }
+                offset += global.reportSize * global.reportCount;
+                clearLocals();
+                break;
+            }
+            case 0xA: // Collection
+                ++collectionDepth;
+                clearLocals();
+                break;
+            case 0xC: // End Collection
+                if (--collectionDepth < 0)
+                    return false;
+                clearLocals();
+                break;
+            default: // Output, Feature
+                clearLocals();
+                break;
+            }
+        }
+        else if (type == 1) // Global
+        {
+            switch (tag)
+            {
+            case 0x0: global.usagePage = static_cast<uint16_t>(data); break;
+            case 0x1: global.logicalMinimum = SignExtend(data, dataSize); break;
+            case 0x2: global.logicalMaximum = SignExtend(data, dataSize); break;
+            case 0x7: global.reportSize = data; break;
+            case 0x8: global.reportId = static_cast<uint8_t>(data); break;
+            case 0x9: global.reportCount = data; break;
+            case 0xA: globalStack.push_back(global); break;
+            case 0xB:
+                if (globalStack.empty())
+                    return false;
+                global = globalStack.back();
+                globalStack.pop_back();
+                break;
+            default: break;
+            }
+        }
+        else if (type == 2) // Local
+        {
+            switch (tag)
+            {
+            case 0x0: usages.push_back(dataSize == 4 ? data : (data & 0xFFFF)); break;
+            case 0x1: usageMinimum = data; hasUsageRange = true; break;
+            case 0x2: usageMaximum = data; hasUsageRange = true; break;
+            default: break;
+            }
+        }
+    }
+
+    if (collectionDepth != 0)
+        return false;
+
+    for (auto& [reportId, elements] : parsed)
+    {
+        auto& plan = m_reports[reportId];
+        plan.valid = true;
+        plan.bitSize = reportBits[reportId];
+        plan.firstElement = static_cast<uint32_t>(m_elements.size());
+        plan.elementCount = static_cast<uint32_t>(elements.size());
+        m_elements.insert(m_elements.end(), elements.begin(), elements.end());
+    }
+    return true;
+}
+
+size_t HidReportDecoder::Decode(uint8_t reportId, const uint8_t* data, size_t size, HidUsageValue* out, size_t capacity) const
+{
+    const auto& plan = m_reports[reportId];
+    if (!plan.valid || size * 8 < plan.bitSize)
+        return 0;
+
+    size_t written = 0;
+    const Element* element = m_elements.data() + plan.firstElement;
+    const Element* end = element + plan.elementCount;
+    for (; element != end && written < capacity; ++element)
+    {
+        uint32_t raw = ExtractBits(data, element->bitOffset, element->bitSize);
+        int32_t value = static_cast<int32_t>(raw);
+        if (element->isSigned && element->bitSize < 32 && (raw >> (element->bitSize - 1)) != 0)
+            value = static_cast<int32_t>(raw | (~0u << element->bitSize));
+
+        if (!element->isArray)
+        {
+            out[written++] = { element->usagePage, element->usage, value, element->relative };
+            continue;
+        }
+
+        // An array slot holds an index into the usage range; out of range means empty.
+        if (value < element->logicalMinimum || value > element->logicalMaximum)
+            continue;
+        auto usage = static_cast<uint16_t>(element->usage + (value - element->logicalMinimum));
+        if (usage != 0)
+            out[written++] = { element->usagePage, usage, 1, false };
+    }
+    return written;
+}
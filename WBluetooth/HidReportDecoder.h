@@ -0,0 +1,73 @@
+#ifndef HID_REPORT_DECODER_H
+#define HID_REPORT_DECODER_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// One usage carried by a report, as a host would see it.
+struct HidUsageValue
+{
+    uint16_t usagePage;
+    uint16_t usage;
+    int32_t value;
+    bool relative;
+};
+
+// Host-side view of our report maps: Parse() walks a report map once, item
+// by item, and compiles its input items into a flat extraction plan per
+// report ID. Decode() then turns captured report bytes back into usages
+// with nothing but shifts and masks, so recorded runs can be checked at
+// full speed.
+//
+// Variable fields decode to one value per element, zeros included. Array
+// fields decode to the usages they currently hold, each with value 1.
+class HidReportDecoder
+{
+public:
+    HidReportDecoder() = default;
+
+    // Adds the input reports described by a report map. Returns false on a
+    // truncated item or unbalanced collections; the plan is unchanged then.
+    bool Parse(const uint8_t* reportMap, size_t size);
+
+    bool HasReport(uint8_t reportId) const { return m_reports[reportId].valid; }
+    size_t GetReportSize(uint8_t reportId) const { return (m_reports[reportId].bitSize + 7) / 8; }
+
+    // Writes up to capacity usages to out and returns how many were written,
+    // or 0 if the report ID is unknown or the data is shorter than the report.
+    // A known report may hold no usages at all, e.g. a consumer control key
+    // release; check HasReport() and GetReportSize() to tell the two apart.
+    size_t Decode(uint8_t reportId, const uint8_t* data, size_t size, HidUsageValue* out, size_t capacity) const;
+
+private:
+    // One element of an input item: a single variable value, or one slot of an array.
+    struct Element
+    {
+        uint32_t bitOffset;
+        uint8_t bitSize;
+        bool isArray;
+        bool isSigned;
+        bool relative;
+        uint16_t usagePage;
+        uint16_t usage;          // variable: the element's usage; array: usage of logicalMinimum
+        int32_t logicalMinimum;
+        int32_t logicalMaximum;
+    };
+
+    struct ReportPlan
+    {
+        bool valid = false;
+        uint32_t bitSize = 0;
+        uint32_t firstElement = 0;
+        uint32_t elementCount = 0;
+    };
+
+    static uint32_t ExtractBits(const uint8_t* data, uint32_t bitOffset, uint8_t bitSize);
+
+    std::vector<Element> m_elements;
+    std::array<ReportPlan, 256> m_reports{};
+};
+
+#endif // HID_REPORT_DECODER_H
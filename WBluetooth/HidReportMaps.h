@@ -0,0 +1,209 @@
+#ifndef HID_REPORT_MAPS_H
+#define HID_REPORT_MAPS_H
+
+#include "HidDescriptor.h"
+#include "HidReports.h"
+#include "HidReportSink.h"
+
+// Report maps served by VirtualKeyboard and VirtualMouse, built at compile time
+// and checked against the packed report structs the engines fill.
+namespace HidReportMaps
+{
+    using namespace HidDescriptor;
+
+    constexpr uint8_t KeyboardReportId = static_cast<uint8_t>(HidReportId::Keyboard);
+    constexpr uint8_t ConsumerReportId = static_cast<uint8_t>(HidReportId::ConsumerControl);
+    constexpr uint8_t MouseReportId = static_cast<uint8_t>(HidReportId::Mouse);
+    constexpr uint8_t DigitizerReportId = static_cast<uint8_t>(HidReportId::Digitizer);
+
+    // Boot-style keyboard (modifier bits, reserved byte, six key slots) and a
+    // 16-bit consumer control usage.
+    constexpr auto Keyboard = Build({
+        UsagePage(Page::GenericDesktop),
+        Usage(UsageId::Keyboard),
+        Collection(CollectionType::Application),
+            ReportId(KeyboardReportId),
+            UsagePage(Page::Keyboard),
+            UsageMinimum(0xE0),
+            UsageMaximum(0xE7),
+            LogicalMinimum(0),
+            LogicalMaximum(1),
+            ReportCount(8),
+            ReportSize(1),
+            Input(Data | Variable | Absolute),
+            ReportCount(1),
+            ReportSize(8),
+            Input(Constant),
+            UsagePage(Page::Keyboard),
+            UsageMinimum(0x00),
+            UsageMaximum(0xFF),
+            LogicalMinimum(0),
+            LogicalMaximum(0xFF),
+            ReportCount(6),
+            ReportSize(8),
+            Input(Data | Array | Absolute),
+        EndCollection(),
+
+        UsagePage(Page::Consumer),
+        Usage(UsageId::ConsumerControl),
+        Collection(CollectionType::Application),
+            ReportId(ConsumerReportId),
+            LogicalMinimum(0),
+            LogicalMaximum(0x029C),
+            UsageMinimum(0x0000),
+            UsageMaximum(0x029C),
+            ReportCount(1),
+            ReportSize(16),
+            Input(Data | Array | Absolute),
+        EndCollection(),
+    });
+
+    // Two buttons and 8-bit relative X, Y and wheel.
+    constexpr auto Mouse = Build({
+        UsagePage(Page::GenericDesktop),
+        Usage(UsageId::Mouse),
+        Collection(CollectionType::Application),
+            ReportId(MouseReportId),
+            Usage(UsageId::Pointer),
+            Collection(CollectionType::Physical),
+                UsagePage(Page::Button),
+                UsageMinimum(0x01),
+                UsageMaximum(0x02),
+                LogicalMinimum(0),
+                LogicalMaximum(1),
+                ReportSize(1),
+                ReportCount(2),
+                Input(Data | Variable | Absolute),
+                ReportCount(6),
+                Input(Constant | Variable | Absolute),
+                UsagePage(Page::GenericDesktop),
+                Usage(UsageId::X),
+                Usage(UsageId::Y),
+                Usage(UsageId::Wheel),
+                LogicalMinimum(-127),
+                LogicalMaximum(127),
+                ReportSize(8),
+                ReportCount(3),
+                Input(Data | Variable | Relative),
+            EndCollection(),
+        EndCollection(),
+    });
+
+    // Five buttons and 16-bit relative X, Y, wheel and AC Pan (horizontal
+    // scroll), so a fling or a long scroll fits one report. Replaces Mouse
+    // under the same report ID when the high-resolution profile is enabled.
+    constexpr auto HighResolutionMouse = Build({
+        UsagePage(Page::GenericDesktop),
+        Usage(UsageId::Mouse),
+        Collection(CollectionType::Application),
+            ReportId(MouseReportId),
+            Usage(UsageId::Pointer),
+            Collection(CollectionType::Physical),
+                UsagePage(Page::Button),
+                UsageMinimum(0x01),
+                UsageMaximum(0x05),
+                LogicalMinimum(0),
+                LogicalMaximum(1),
+                ReportSize(1),
+                ReportCount(5),
+                Input(Data | Variable | Absolute),
+                ReportCount(3),
+                Input(Constant | Variable | Absolute),
+                UsagePage(Page::GenericDesktop),
+                Usage(UsageId::X),
+                Usage(UsageId::Y),
+                Usage(UsageId::Wheel),
+                LogicalMinimum(-32767),
+                LogicalMaximum(32767),
+                ReportSize(16),
+                ReportCount(3),
+                Input(Data | Variable | Relative),
+                UsagePage(Page::Consumer),
+                Usage(UsageId::ACPan),
+                ReportCount(1),
+                Input(Data | Variable | Relative),
+            EndCollection(),
+        EndCollection(),
+    });
+
+    // Single-contact touch screen with a 16-bit absolute range, appended to the
+    // mouse map when the absolute pointer profile is enabled.
+    constexpr auto Digitizer = Build({
+        UsagePage(Page::Digitizer),
+        Usage(UsageId::TouchScreen),
+        Collection(CollectionType::Application),
+            ReportId(DigitizerReportId),
+            Usage(UsageId::Finger),
+            Collection(CollectionType::Logical),
+                Usage(UsageId::TipSwitch),
+                Usage(UsageId::InRange),
+                LogicalMinimum(0),
+                LogicalMaximum(1),
+                ReportSize(1),
+                ReportCount(2),
+                Input(Data | Variable | Absolute),
+                ReportCount(6),
+                Input(Constant | Variable | Absolute),
+                UsagePage(Page::GenericDesktop),
+                Usage(UsageId::X),
+                Usage(UsageId::Y),
+                LogicalMinimum(0),
+                LogicalMaximum(0x7FFF),
+                ReportSize(16),
+                ReportCount(2),
+                Input(Data | Variable | Absolute),
+            EndCollection(),
+        EndCollection(),
+    });
+
+    // True when the map puts a field exactly where the report struct has it.
+    constexpr bool IsAt(const Field& field, size_t bitOffset, size_t bitSize, size_t count = 1)
+    {
+        return field.found && field.bitOffset == bitOffset && field.bitSize == bitSize && field.count == count;
+    }
+
+    static_assert(InputReportBits(Keyboard, KeyboardReportId) == sizeof(KeyboardInputReport) * 8,
+        "keyboard report struct does not match the report map");
+    static_assert(IsAt(FindInputField(Keyboard, KeyboardReportId, Page::Keyboard, 0xE0), offsetof(KeyboardInputReport, modifiers) * 8, 1) &&
+        IsAt(FindInputField(Keyboard, KeyboardReportId, Page::Keyboard, 0xE7), offsetof(KeyboardInputReport, modifiers) * 8 + 7, 1),
+        "keyboard modifier bits are misplaced");
+    static_assert(IsAt(FindInputField(Keyboard, KeyboardReportId, Page::Keyboard, 0x04), offsetof(KeyboardInputReport, keys) * 8, 8,
+        sizeof(KeyboardInputReport::keys)), "keyboard key slots are misplaced");
+
+    static_assert(InputReportBits(Keyboard, ConsumerReportId) == sizeof(ConsumerControlReport) * 8,
+        "consumer report struct does not match the report map");
+    static_assert(IsAt(FindInputField(Keyboard, ConsumerReportId, Page::Consumer, 0x00E9), offsetof(ConsumerControlReport, usageLow) * 8, 16),
+        "consumer usage is misplaced");
+
+    static_assert(InputReportBits(Mouse, MouseReportId) == sizeof(MouseInputReport) * 8,
+        "mouse report struct does not match the report map");
+    static_assert(IsAt(FindInputField(Mouse, MouseReportId, Page::Button, 1), offsetof(MouseInputReport, buttons) * 8, 1) &&
+        IsAt(FindInputField(Mouse, MouseReportId, Page::Button, 2), offsetof(MouseInputReport, buttons) * 8 + 1, 1),
+        "mouse buttons are misplaced");
+    static_assert(IsAt(FindInputField(Mouse, MouseReportId, Page::GenericDesktop, UsageId::X), offsetof(MouseInputReport, x) * 8, 8) &&
+        IsAt(FindInputField(Mouse, MouseReportId, Page::GenericDesktop, UsageId::Y), offsetof(MouseInputReport, y) * 8, 8) &&
+        IsAt(FindInputField(Mouse, MouseReportId, Page::GenericDesktop, UsageId::Wheel), offsetof(MouseInputReport, wheel) * 8, 8),
+        "mouse axes are misplaced");
+
+    static_assert(InputReportBits(HighResolutionMouse, MouseReportId) == sizeof(HighResolutionMouseInputReport) * 8,
+        "high-resolution mouse report struct does not match the report map");
+    static_assert(IsAt(FindInputField(HighResolutionMouse, MouseReportId, Page::Button, 1), offsetof(HighResolutionMouseInputReport, buttons) * 8, 1) &&
+        IsAt(FindInputField(HighResolutionMouse, MouseReportId, Page::Button, 5), offsetof(HighResolutionMouseInputReport, buttons) * 8 + 4, 1),
+        "high-resolution mouse buttons are misplaced");
+    static_assert(IsAt(FindInputField(HighResolutionMouse, MouseReportId, Page::GenericDesktop, UsageId::X), offsetof(HighResolutionMouseInputReport, xLow) * 8, 16) &&
+        IsAt(FindInputField(HighResolutionMouse, MouseReportId, Page::GenericDesktop, UsageId::Y), offsetof(HighResolutionMouseInputReport, yLow) * 8, 16) &&
+        IsAt(FindInputField(HighResolutionMouse, MouseReportId, Page::GenericDesktop, UsageId::Wheel), offsetof(HighResolutionMouseInputReport, wheelLow) * 8, 16) &&
+        IsAt(FindInputField(HighResolutionMouse, MouseReportId, Page::Consumer, UsageId::ACPan), offsetof(HighResolutionMouseInputReport, panLow) * 8, 16),
+        "high-resolution mouse axes are misplaced");
+
+    static_assert(InputReportBits(Digitizer, DigitizerReportId) == sizeof(DigitizerInputReport) * 8,
+        "digitizer report struct does not match the report map");
+    static_assert(IsAt(FindInputField(Digitizer, DigitizerReportId, Page::Digitizer, UsageId::TipSwitch), offsetof(DigitizerInputReport, flags) * 8, 1) &&
+        IsAt(FindInputField(Digitizer, DigitizerReportId, Page::Digitizer, UsageId::InRange), offsetof(DigitizerInputReport, flags) * 8 + 1, 1),
+        "digitizer contact bits are misplaced");
+    static_assert(IsAt(FindInputField(Digitizer, DigitizerReportId, Page::GenericDesktop, UsageId::X), offsetof(DigitizerInputReport, xLow) * 8, 16) &&
+        IsAt(FindInputField(Digitizer, DigitizerReportId, Page::GenericDesktop, UsageId::Y), offsetof(DigitizerInputReport, yLow) * 8, 16),
+        "digitizer axes are misplaced");
+}
+
+#endif // HID_REPORT_MAPS_H
@@ -0,0 +1,136 @@
+#include "HidReportMonitor.h"
+#include "HidReportMaps.h"
+#include <array>
+
+HidReportMonitor::HidReportMonitor(bool highResolutionMouse)
+{
+    m_decoder.Parse(HidReportMaps::Keyboard.begin(), HidReportMaps::Keyboard.size);
+    if (highResolutionMouse)
+        m_decoder.Parse(HidReportMaps::HighResolutionMouse.begin(), HidReportMaps::HighResolutionMouse.size);
+    else
+        m_decoder.Parse(HidReportMaps::Mouse.begin(), HidReportMaps::Mouse.size);
+    m_decoder.Parse(HidReportMaps::Digitizer.begin(), HidReportMaps::Digitizer.size);
+}
+
+void HidReportMonitor::OnReport(HidReportId reportId, const uint8_t* data, size_t size)
+{
+    auto id = static_cast<uint8_t>(reportId);
+    bool known = m_decoder.HasReport(id) && size >= m_decoder.GetReportSize(id);
+    std::array<HidUsageValue, m_maxUsagesPerReport> usages;
+    size_t count = known ? m_decoder.Decode(id, data, size, usages.data(), usages.size()) : 0;
+
+    auto now = std::chrono::steady_clock::now();
+    std::scoped_lock lock(m_mutex);
+    if (m_reportCount++ == 0)
+        m_firstReportTime = now;
+    m_lastReportTime = now;
+
+    // A known report with no usages in it, such as a consumer release, still counts.
+    if (!known)
+    {
+        ++m_undecodableCount;
+        return;
+    }
+
+    switch (reportId)
+    {
+    case HidReportId::Keyboard:
+    {
+        // Absolute state: the report replaces whatever was held before.
+        std::bitset<256> keys;
+        for (size_t i = 0; i < count; ++i)
+            if (usages[i].usagePage == HidDescriptor::Page::Keyboard && usages[i].value != 0 && usages[i].usage < keys.size())
+                keys.set(usages[i].usage);
+        m_eventCount += (keys ^ m_state.keys).count();
+        m_state.keys = keys;
+        break;
+    }
+    case HidReportId::ConsumerControl:
+    {
+        uint16_t usage = 0;
+        for (size_t i = 0; i < count; ++i)
+            if (usages[i].usagePage == HidDescriptor::Page::Consumer)
+                usage = usages[i].usage;
+        m_eventCount += usage != m_state.consumerUsage;
+        m_state.consumerUsage = usage;
+        break;
+    }
+    case HidReportId::Mouse:
+    {
+        uint8_t buttons = 0;
+        bool moved = false;
+        for (size_t i = 0; i < count; ++i)
+        {
+            const auto& usage = usages[i];
+            if (usage.usagePage == HidDescriptor::Page::Button && usage.value != 0 && usage.usage >= 1 && usage.usage <= 8)
+                buttons |= static_cast<uint8_t>(1u << (usage.usage - 1));
+            else if (usage.usagePage == HidDescriptor::Page::GenericDesktop && usage.relative && usage.value != 0)
+            {
+                moved = true;
+                if (usage.usage == HidDescriptor::UsageId::X)
+                    m_state.pointerX += usage.value;
+                else if (usage.usage == HidDescriptor::UsageId::Y)
+                    m_state.pointerY += usage.value;
+                else if (usage.usage == HidDescriptor::UsageId::Wheel)
+                    m_state.wheel += usage.value;
+            }
+            else if (usage.usagePage == HidDescriptor::Page::Consumer && usage.usage == HidDescriptor::UsageId::ACPan &&
+                usage.relative && usage.value != 0)
+            {
+                moved = true;
+                m_state.pan += usage.value;
+            }
+        }
+        m_eventCount += std::bitset<8>(buttons ^ m_state.mouseButtons).count() + (moved ? 1 : 0);
+        m_state.mouseButtons = buttons;
+        break;
+    }
+    case HidReportId::Digitizer:
+    {
+        bool touching = false;
+        uint16_t x = m_state.touchX, y = m_state.touchY;
+        for (size_t i = 0; i < count; ++i)
+        {
+            const auto& usage = usages[i];
+            if (usage.usagePage == HidDescriptor::Page::Digitizer && usage.usage == HidDescriptor::UsageId::TipSwitch)
+                touching = usage.value != 0;
+            else if (usage.usagePage == HidDescriptor::Page::GenericDesktop && usage.usage == HidDescriptor::UsageId::X)
+                x = static_cast<uint16_t>(usage.value);
+            else if (usage.usagePage == HidDescriptor::Page::GenericDesktop && usage.usage == HidDescriptor::UsageId::Y)
+                y = static_cast<uint16_t>(usage.value);
+        }
+        m_eventCount += (touching != m_state.touching) + (x != m_state.touchX || y != m_state.touchY);
+        m_state.touching = touching;
+        m_state.touchX = x;
+        m_state.touchY = y;
+        break;
+    }
+    }
+}
+
+HidHostState HidReportMonitor::GetState() const
+{
+    std::scoped_lock lock(m_mutex);
+    return m_state;
+}
+
+HidMonitorStats HidReportMonitor::GetStats() const
+{
+    std::scoped_lock lock(m_mutex);
+    double seconds = std::chrono::duration<double>(m_lastReportTime - m_firstReportTime).count();
+    return {
+        m_reportCount,
+        m_eventCount,
+        m_undecodableCount,
+        seconds > 0.0 ? static_cast<double>(m_eventCount) / seconds : 0.0
+    };
+}
+
+void HidReportMonitor::Reset()
+{
+    std::scoped_lock lock(m_mutex);
+    m_state = HidHostState{};
+    m_reportCount = 0;
+    m_eventCount = 0;
+    m_undecodableCount = 0;
+}
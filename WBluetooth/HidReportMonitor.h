@@ -0,0 +1,63 @@
+#ifndef HID_REPORT_MONITOR_H
+#define HID_REPORT_MONITOR_H
+
+#include "HidReportDecoder.h"
+#include "HidReportSink.h"
+#include <bitset>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+// What a host would believe after the reports seen so far.
+struct HidHostState
+{
+    std::bitset<256> keys;      // keyboard page usages held, modifiers included
+    uint16_t consumerUsage;
+    uint8_t mouseButtons;       // bit n is button n + 1
+    int64_t pointerX;           // relative motion summed up
+    int64_t pointerY;
+    int64_t wheel;
+    int64_t pan;
+    bool touching;
+    uint16_t touchX;            // logical digitizer coordinates
+    uint16_t touchY;
+};
+
+struct HidMonitorStats
+{
+    uint64_t reports;
+    uint64_t events;            // key, button, touch and consumer transitions plus motion reports
+    uint64_t undecodable;
+    double eventsPerSecond;     // between the first and the last report
+};
+
+// Decodes delivered reports against our own report maps and keeps the host
+// state they add up to. Hook OnReport() up as a LoopbackReportSink handler to
+// check that a long replay means what it was meant to, at full speed.
+class HidReportMonitor
+{
+public:
+    // The mouse reports are read against the map of the profile in use.
+    explicit HidReportMonitor(bool highResolutionMouse = false);
+
+    void OnReport(HidReportId reportId, const uint8_t* data, size_t size);
+
+    HidHostState GetState() const;
+    HidMonitorStats GetStats() const;
+    void Reset();
+
+private:
+    static constexpr size_t m_maxUsagesPerReport = 32;
+
+    HidReportDecoder m_decoder;
+
+    mutable std::mutex m_mutex;
+    HidHostState m_state{};
+    uint64_t m_reportCount = 0;
+    uint64_t m_eventCount = 0;
+    uint64_t m_undecodableCount = 0;
+    std::chrono::steady_clock::time_point m_firstReportTime;
+    std::chrono::steady_clock::time_point m_lastReportTime;
+};
+
+#endif // HID_REPORT_MONITOR_H
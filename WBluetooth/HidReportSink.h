@@ -0,0 +1,32 @@
+#ifndef HID_REPORT_SINK_H
+#define HID_REPORT_SINK_H
+
+#include "BleEmulatorTypes.h"
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <thread>
+
+// Transport for input reports. The report engines only build report bytes;
+// a sink decides where they go (GATT notifications, in-process loopback, ...).
+class HidReportSink
+{
+public:
+    virtual ~HidReportSink() = default;
+
+    // True when somebody is listening on the report, i.e. sending is not wasted.
+    virtual bool IsReady(HidReportId reportId) const = 0;
+
+    // Deliver one report. Returns once the transport has accepted it.
+    virtual void SendReport(HidReportId reportId, const uint8_t* data, size_t size) = 0;
+
+    // Deliver one report once delay has passed, ahead of any report on the same
+    // ID sent after this call. Sinks without a scheduler hold the caller for the delay.
+    virtual void SendReportAfter(HidReportId reportId, const uint8_t* data, size_t size, std::chrono::microseconds delay)
+    {
+        std::this_thread::sleep_for(delay);
+        SendReport(reportId, data, size);
+    }
+};
+
+#endif // HID_REPORT_SINK_H
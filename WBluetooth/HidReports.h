@@ -0,0 +1,136 @@
+#ifndef HID_REPORTS_H
+#define HID_REPORTS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Wire layout of the input reports described by the report maps in
+// HidReportMaps.h (without the report ID byte, which GATT carries in the
+// Report Reference descriptor). HidReportMaps.h checks every field against its map.
+
+#pragma pack(push, 1)
+
+struct KeyboardInputReport
+{
+    uint8_t modifiers;
+    uint8_t reserved;
+    uint8_t keys[6];
+};
+
+struct ConsumerControlReport
+{
+    uint8_t usageLow;
+    uint8_t usageHigh;
+};
+
+struct MouseInputReport
+{
+    uint8_t buttons;
+    int8_t x;
+    int8_t y;
+    int8_t wheel;
+};
+
+// High-resolution mouse profile: five buttons, 16-bit relative X, Y, wheel
+// and horizontal pan, little-endian.
+struct HighResolutionMouseInputReport
+{
+    uint8_t buttons;    // bits 0-4 left, right, middle, back, forward
+    uint8_t xLow;
+    uint8_t xHigh;
+    uint8_t yLow;
+    uint8_t yHigh;
+    uint8_t wheelLow;
+    uint8_t wheelHigh;
+    uint8_t panLow;
+    uint8_t panHigh;
+};
+
+struct DigitizerInputReport
+{
+    uint8_t flags;      // bit 0 tip switch, bit 1 in range
+    uint8_t xLow;
+    uint8_t xHigh;
+    uint8_t yLow;
+    uint8_t yHigh;
+};
+
+#pragma pack(pop)
+
+static_assert(sizeof(KeyboardInputReport) == 8, "keyboard report must match the report map");
+static_assert(sizeof(ConsumerControlReport) == 2, "consumer report must match the report map");
+static_assert(sizeof(MouseInputReport) == 4, "mouse report must match the report map");
+static_assert(sizeof(HighResolutionMouseInputReport) == 9, "high-resolution mouse report must match the report map");
+static_assert(sizeof(DigitizerInputReport) == 5, "digitizer report must match the report map");
+
+// Largest report any engine produces; transport buffers are sized for it.
+constexpr size_t MaxHidReportSizeInBytes = 16;
+
+// A mouse report of either profile taken apart, for the layers that merge or
+// compare mouse reports; the report size tells the profiles apart.
+struct MouseReportFields
+{
+    uint8_t buttons;
+    int32_t x;
+    int32_t y;
+    int32_t wheel;
+    int32_t pan;
+};
+
+// Largest delta per axis a mouse report of this size carries, 0 if it is not one.
+inline int32_t MaxMouseDelta(size_t size)
+{
+    return size == sizeof(HighResolutionMouseInputReport) ? 32767 : size == sizeof(MouseInputReport) ? 127 : 0;
+}
+
+inline bool UnpackMouseReport(const uint8_t* data, size_t size, MouseReportFields& fields)
+{
+    auto read16 = [](uint8_t low, uint8_t high) { return static_cast<int32_t>(static_cast<int16_t>(low | (high << 8))); };
+    if (size == sizeof(HighResolutionMouseInputReport))
+    {
+        HighResolutionMouseInputReport report;
+        std::memcpy(&report, data, sizeof(report));
+        fields = { report.buttons, read16(report.xLow, report.xHigh), read16(report.yLow, report.yHigh),
+            read16(report.wheelLow, report.wheelHigh), read16(report.panLow, report.panHigh) };
+        return true;
+    }
+    if (size == sizeof(MouseInputReport))
+    {
+        MouseInputReport report;
+        std::memcpy(&report, data, sizeof(report));
+        fields = { report.buttons, report.x, report.y, report.wheel, 0 };
+        return true;
+    }
+    return false;
+}
+
+// Values must be within MaxMouseDelta(size); the standard profile drops pan.
+inline void PackMouseReport(const MouseReportFields& fields, uint8_t* data, size_t size)
+{
+    if (size == sizeof(HighResolutionMouseInputReport))
+    {
+        HighResolutionMouseInputReport report;
+        report.buttons = fields.buttons;
+        report.xLow = static_cast<uint8_t>(fields.x);
+        report.xHigh = static_cast<uint8_t>(fields.x >> 8);
+        report.yLow = static_cast<uint8_t>(fields.y);
+        report.yHigh = static_cast<uint8_t>(fields.y >> 8);
+        report.wheelLow = static_cast<uint8_t>(fields.wheel);
+        report.wheelHigh = static_cast<uint8_t>(fields.wheel >> 8);
+        report.panLow = static_cast<uint8_t>(fields.pan);
+        report.panHigh = static_cast<uint8_t>(fields.pan >> 8);
+        std::memcpy(data, &report, sizeof(report));
+    }
+    else if (size == sizeof(MouseInputReport))
+    {
+        MouseInputReport report;
+        report.buttons = fields.buttons;
+        report.x = static_cast<int8_t>(fields.x);
+        report.y = static_cast<int8_t>(fields.y);
+        report.wheel = static_cast<int8_t>(fields.wheel);
+        std::memcpy(data, &report, sizeof(report));
+    }
+}
+
+#endif // HID_REPORTS_H
@@ -0,0 +1,108 @@
+#include "InputClient.h"
+#include "InputLatency.h"
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+InputClient::~InputClient()
+{
+    Disconnect();
+}
+
+bool InputClient::Connect(const std::string& name)
+{
+    Disconnect();
+
+    if (!m_ring.Open(name))
+        return false;
+    m_socket = LocalSocket::Connect(InputIpc::SocketPath(name));
+    if (m_socket == LocalSocket::m_invalid)
+    {
+        m_ring.Close();
+        return false;
+    }
+    return true;
+}
+
+void InputClient::Disconnect()
+{
+    LocalSocket::Close(m_socket);
+    m_socket = LocalSocket::m_invalid;
+    m_ring.Close();
+}
+
+bool InputClient::Send(const InputEvent& event, std::chrono::milliseconds timeout)
+{
+    if (!m_ring.IsOpen())
+        return false;
+
+    auto wire = InputIpc::ToWire(event);
+    if (wire.timestamp == 0)
+        wire.timestamp = ReportOrigin::Now();
+    if (m_ring.TryPush(wire))
+        return true;
+
+    // Full: the daemon is behind, give it the CPU.
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    do
+    {
+        std::this_thread::yield();
+        if (m_ring.TryPush(wire))
+            return true;
+    } while (std::chrono::steady_clock::now() < deadline);
+    return false;
+}
+
+bool InputClient::Request(InputIpc::MessageType type, const void* payload, size_t size, InputIpc::Reply& reply)
+{
+    if (m_socket == LocalSocket::m_invalid || size > InputIpc::m_maxMessagePayloadSizeInBytes)
+        return false;
+
+    InputIpc::MessageHeader header{ InputIpc::m_magic, static_cast<uint32_t>(type), static_cast<uint32_t>(size), 0 };
+    return LocalSocket::SendAll(m_socket, &header, sizeof(header)) &&
+        (size == 0 || LocalSocket::SendAll(m_socket, payload, size)) &&
+        LocalSocket::ReceiveAll(m_socket, &reply, sizeof(reply));
+}
+
+size_t InputClient::SendBatch(const InputEvent* events, size_t count)
+{
+    size_t taken = 0;
+    std::vector<InputIpc::WireEvent> wire;
+    uint64_t now = ReportOrigin::Now();
+    while (taken < count)
+    {
+        size_t chunk = std::min(count - taken, InputIpc::m_maxEventsPerMessage);
+        wire.clear();
+        for (size_t i = 0; i < chunk; ++i)
+        {
+            wire.push_back(InputIpc::ToWire(events[taken + i]));
+            if (wire.back().timestamp == 0)
+                wire.back().timestamp = now;
+        }
+
+        InputIpc::Reply reply{};
+        if (!Request(InputIpc::MessageType::Events, wire.data(), wire.size() * sizeof(wire[0]), reply) ||
+            (reply.status != static_cast<uint32_t>(InputIpc::Status::Ok) &&
+                reply.status != static_cast<uint32_t>(InputIpc::Status::Dropped)) ||
+            reply.count == 0)
+            break;
+        taken += reply.count;
+    }
+    return taken;
+}
+
+size_t InputClient::TypeText(const std::string& utf8)
+{
+    InputIpc::Reply reply{};
+    if (!Request(InputIpc::MessageType::Text, utf8.data(), utf8.size(), reply) ||
+        reply.status != static_cast<uint32_t>(InputIpc::Status::Ok))
+        return utf8.size();
+    return reply.count;
+}
+
+bool InputClient::Flush()
+{
+    InputIpc::Reply reply{};
+    return Request(InputIpc::MessageType::Flush, nullptr, 0, reply) &&
+        reply.status == static_cast<uint32_t>(InputIpc::Status::Ok);
+}
@@ -0,0 +1,49 @@
+#ifndef INPUT_CLIENT_H
+#define INPUT_CLIENT_H
+
+#include "InputEvent.h"
+#include "LocalSocket.h"
+#include "SharedInputRing.h"
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+// Producer side of the local IPC front-end (see InputIpc.h), for capture and
+// automation processes feeding an emulator daemon on the same machine.
+// Send() may be called from several threads at once; the control socket
+// calls (SendBatch, TypeText, Flush) from one thread at a time.
+class InputClient
+{
+public:
+    InputClient() = default;
+    ~InputClient();
+
+    InputClient(const InputClient&) = delete;
+    InputClient& operator=(const InputClient&) = delete;
+
+    // Attaches to the daemon started under name.
+    bool Connect(const std::string& name);
+    void Disconnect();
+    bool IsConnected() const { return m_ring.IsOpen(); }
+
+    // Through the shared ring: no system call unless the daemon is idle.
+    // Waits up to timeout for room; false if the daemon did not make any.
+    bool Send(const InputEvent& event, std::chrono::milliseconds timeout = std::chrono::milliseconds(100));
+
+    // Through the control socket, one round trip per call; events are taken
+    // all or none. Returns how many were taken.
+    size_t SendBatch(const InputEvent* events, size_t count);
+    // Returns the number of characters with no key on the daemon's layout,
+    // or text.size() if the daemon could not be reached.
+    size_t TypeText(const std::string& utf8);
+    // Returns once everything sent so far has gone out to the host.
+    bool Flush();
+
+private:
+    bool Request(InputIpc::MessageType type, const void* payload, size_t size, InputIpc::Reply& reply);
+
+    SharedInputRing m_ring;
+    LocalSocket::Handle m_socket = LocalSocket::m_invalid;
+};
+
+#endif // INPUT_CLIENT_H
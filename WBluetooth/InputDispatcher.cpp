@@ -0,0 +1,317 @@
+#include "InputDispatcher.h"
+
+InputDispatcher::InputDispatcher(EventHandler handler, size_t capacity, BackpressurePolicy policy)
+    : m_handler(std::move(handler))
+    , m_queue(capacity)
+    , m_policy(policy)
+{
+}
+
+InputDispatcher::~InputDispatcher()
+{
+    Stop();
+}
+
+void InputDispatcher::Start()
+{
+    if (m_running.exchange(true))
+        return;
+
+    m_senderThread = std::thread(&InputDispatcher::SenderLoop, this);
+}
+
+void InputDispatcher::Stop()
+{
+    if (!m_running.exchange(false))
+        return;
+
+    {
+        std::scoped_lock lock(m_wakeMutex);
+        m_wakeCondition.notify_one();
+    }
+    if (m_senderThread.joinable())
+        m_senderThread.join();
+}
+
+void InputDispatcher::SetBackpressurePolicy(BackpressurePolicy policy)
+{
+    m_policy.store(policy, std::memory_order_relaxed);
+}
+
+BackpressurePolicy InputDispatcher::GetBackpressurePolicy() const
+{
+    return m_policy.load(std::memory_order_relaxed);
+}
+
+bool InputDispatcher::Submit(const InputEvent& event)
+{
+    // Motion parked by an earlier overflow goes out ahead of anything newer;
+    // more motion keeps merging into it while the queue stays full.
+    InputEvent pending;
+    if (m_hasCoalescedMotion.load(std::memory_order_acquire) && TakeCoalescedMotion(pending))
+    {
+        if (m_queue.TryPush(pending))
+        {
+            m_submittedEvents.fetch_add(1);
+            m_coalescedInFlight.fetch_sub(1);
+        }
+        else if (event.type == InputEventType::MouseMove)
+        {
+            CoalesceMotion(pending);
+            CoalesceMotion(event);
+            m_coalescedInFlight.fetch_sub(1);
+            m_coalescedEvents.fetch_add(1, std::memory_order_relaxed);
+            WakeSender();
+            return true;
+        }
+        else
+        {
+            PushBlocking(pending);
+            m_coalescedInFlight.fetch_sub(1);
+        }
+    }
+
+    bool delivered = true;
+    if (!m_queue.TryPush(event))
+    {
+        switch (m_policy.load(std::memory_order_relaxed))
+        {
+        case BackpressurePolicy::Block:
+            PushBlocking(event);
+            return true;
+
+        case BackpressurePolicy::DropOldest:
+        {
+            // Releases, clicks and touches always get through, or keys and
+            // buttons would stay down on the host: with one of those at the
+            // front, new motion is dropped instead and anything else waits.
+            InputEvent oldest;
+            while (!m_queue.TryPush(event))
+            {
+                if (m_queue.TryPopIf(oldest, IsMotionEventType))
+                {
+                    m_droppedEvents.fetch_add(1, std::memory_order_relaxed);
+                    m_handledEvents.fetch_add(1);
+                    NotifyFlushWaiters();
+                    delivered = false;
+                }
+                else if (IsMotionEventType(event.type))
+                {
+                    m_droppedEvents.fetch_add(1, std::memory_order_relaxed);
+                    WakeSender();
+                    return false;
+                }
+                else
+                {
+                    PushBlocking(event);
+                    return delivered;
+                }
+            }
+            break;
+        }
+
+        case BackpressurePolicy::Coalesce:
+            if (event.type != InputEventType::MouseMove)
+            {
+                PushBlocking(event);
+                return true;
+            }
+            CoalesceMotion(event);
+            m_coalescedEvents.fetch_add(1, std::memory_order_relaxed);
+            WakeSender();
+            return true;
+        }
+    }
+
+    m_submittedEvents.fetch_add(1);
+    WakeSender();
+    return delivered;
+}
+
+bool InputDispatcher::SubmitBatch(const InputEvent* events, size_t count, uint64_t timestamp)
+{
+    bool delivered = true;
+    size_t done = 0;
+    while (done < count)
+    {
+        // Parked motion has to go out first, which Submit() takes care of.
+        if (!m_hasCoalescedMotion.load(std::memory_order_acquire))
+        {
+            size_t pushed = m_queue.TryPushBatch(events + done, count - done, timestamp);
+            if (pushed != 0)
+            {
+                m_submittedEvents.fetch_add(pushed);
+                done += pushed;
+                continue;
+            }
+        }
+
+        // Full: the backpressure policy decides, one event at a time.
+        InputEvent event = events[done++];
+        if (timestamp != 0)
+            event.timestamp = timestamp;
+        delivered = Submit(event) && delivered;
+    }
+
+    WakeSender();
+    return delivered;
+}
+
+void InputDispatcher::PushBlocking(const InputEvent& event)
+{
+    if (!m_queue.TryPush(event))
+    {
+        auto start = std::chrono::steady_clock::now();
+        m_blockedProducers.fetch_add(1);
+        do
+        {
+            WakeSender();
+            // The sender signals after every pop while anyone waits here; the
+            // timeout only covers a dispatcher that was stopped meanwhile.
+            std::unique_lock lock(m_roomMutex);
+            m_roomCondition.wait_for(lock, m_blockedRecheckInterval, [&] {
+                return m_queue.SizeApprox() < m_queue.Capacity();
+            });
+        } while (!m_queue.TryPush(event));
+        m_blockedProducers.fetch_sub(1);
+
+        auto waited = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        m_blockedSubmissions.fetch_add(1, std::memory_order_relaxed);
+        m_blockedNanoseconds.fetch_add(static_cast<uint64_t>(waited.count()), std::memory_order_relaxed);
+    }
+    m_submittedEvents.fetch_add(1);
+    WakeSender();
+}
+
+ProducerContention InputDispatcher::GetContention() const
+{
+    ProducerContention contention{};
+    contention.queueRetries = m_queue.GetRetryCount();
+    contention.queueFull = m_queue.GetFullCount();
+    contention.blockedSubmissions = m_blockedSubmissions.load(std::memory_order_relaxed);
+    contention.blockedTime = std::chrono::nanoseconds(m_blockedNanoseconds.load(std::memory_order_relaxed));
+    return contention;
+}
+
+void InputDispatcher::CoalesceMotion(const InputEvent& event)
+{
+    {
+        std::scoped_lock lock(m_coalesceMutex);
+        m_coalescedMotion.dx += event.dx;
+        m_coalescedMotion.dy += event.dy;
+        m_coalescedMotion.wheel += event.wheel;
+        m_coalescedMotion.pan += event.pan;
+        // Merged motion is as late as its oldest part.
+        if (m_coalescedMotion.timestamp == 0)
+            m_coalescedMotion.timestamp = event.timestamp;
+        m_hasCoalescedMotion.store(true, std::memory_order_release);
+    }
+}
+
+bool InputDispatcher::TakeCoalescedMotion(InputEvent& event)
+{
+    std::scoped_lock lock(m_coalesceMutex);
+    if (!m_hasCoalescedMotion.load(std::memory_order_relaxed))
+        return false;
+
+    // Stays counted until the caller has queued or handled it, so Flush() can't slip past.
+    m_coalescedInFlight.fetch_add(1);
+    event = m_coalescedMotion;
+    m_coalescedMotion = InputEvent::MouseMove(0, 0, 0);
+    m_hasCoalescedMotion.store(false, std::memory_order_release);
+    return true;
+}
+
+void InputDispatcher::WakeSender()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_senderSleeping.load(std::memory_order_relaxed))
+    {
+        std::scoped_lock lock(m_wakeMutex);
+        m_wakeCondition.notify_one();
+    }
+}
+
+void InputDispatcher::WakeBlockedProducers()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_blockedProducers.load(std::memory_order_relaxed) > 0)
+    {
+        std::scoped_lock lock(m_roomMutex);
+        m_roomCondition.notify_all();
+    }
+}
+
+void InputDispatcher::Flush()
+{
+    if (!m_running.load(std::memory_order_relaxed))
+        return;
+
+    uint64_t target = m_submittedEvents.load();
+    m_flushWaiters.fetch_add(1);
+    WakeSender();
+
+    {
+        std::unique_lock lock(m_flushMutex);
+        m_flushCondition.wait(lock, [&] {
+            return !m_running.load(std::memory_order_relaxed) ||
+                (m_handledEvents.load() >= target && !m_hasCoalescedMotion.load() &&
+                 m_coalescedInFlight.load() == 0);
+        });
+    }
+    m_flushWaiters.fetch_sub(1);
+}
+
+void InputDispatcher::HandleEvent(const InputEvent& event)
+{
+    m_handler(event, !m_queue.Empty() || m_hasCoalescedMotion.load(std::memory_order_acquire));
+    m_handledEvents.fetch_add(1);
+    NotifyFlushWaiters();
+}
+
+void InputDispatcher::NotifyFlushWaiters()
+{
+    if (m_flushWaiters.load() > 0)
+    {
+        std::scoped_lock lock(m_flushMutex);
+        m_flushCondition.notify_all();
+    }
+}
+
+void InputDispatcher::SenderLoop()
+{
+    InputEvent event;
+    while (m_running.load(std::memory_order_relaxed))
+    {
+        if (m_queue.TryPop(event))
+        {
+            WakeBlockedProducers();
+            HandleEvent(event);
+            continue;
+        }
+
+        // Queue drained: motion merged during the overflow is now the newest input.
+        if (TakeCoalescedMotion(event))
+        {
+            m_submittedEvents.fetch_add(1);
+            m_handler(event, !m_queue.Empty());
+            m_handledEvents.fetch_add(1);
+            m_coalescedInFlight.fetch_sub(1);
+            NotifyFlushWaiters();
+            continue;
+        }
+
+        std::unique_lock lock(m_wakeMutex);
+        m_senderSleeping.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        m_wakeCondition.wait(lock, [&] {
+            return !m_running.load(std::memory_order_relaxed) || !m_queue.Empty() ||
+                m_hasCoalescedMotion.load(std::memory_order_acquire);
+        });
+        m_senderSleeping.store(false, std::memory_order_relaxed);
+    }
+
+    // Release any Flush() callers still waiting on a stopped dispatcher.
+    std::scoped_lock lock(m_flushMutex);
+    m_flushCondition.notify_all();
+}
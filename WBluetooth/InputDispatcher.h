@@ -0,0 +1,103 @@
+#ifndef INPUT_DISPATCHER_H
+#define INPUT_DISPATCHER_H
+
+#include "BleEmulatorTypes.h"
+#include "InputEvent.h"
+#include "InputQueue.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// Decouples the public input calls from report transmission: producers push
+// events into a bounded queue and a dedicated sender thread hands them to the
+// report engines, so callers never wait for a notification round trip.
+class InputDispatcher
+{
+public:
+    // moreQueued tells the handler whether another event is already waiting,
+    // i.e. whether this is the last chance to transmit before going idle.
+    using EventHandler = std::function<void(const InputEvent& event, bool moreQueued)>;
+
+    static constexpr size_t m_defaultQueueCapacity = 1024;
+
+    InputDispatcher(EventHandler handler, size_t capacity = m_defaultQueueCapacity,
+        BackpressurePolicy policy = BackpressurePolicy::Block);
+    ~InputDispatcher();
+
+    InputDispatcher(const InputDispatcher&) = delete;
+    InputDispatcher& operator=(const InputDispatcher&) = delete;
+
+    void Start();
+    void Stop();
+
+    // Returns false when the event (or an older one, under DropOldest) was
+    // discarded. Only motion is ever discarded.
+    bool Submit(const InputEvent& event);
+    // Queues events in order with as few queue operations as room allows,
+    // waking the sender once; falls back to Submit() per event when full.
+    // A nonzero timestamp replaces the events' own.
+    bool SubmitBatch(const InputEvent* events, size_t count, uint64_t timestamp = 0);
+
+    // Waits until every event submitted before the call has been handled.
+    void Flush();
+
+    void SetBackpressurePolicy(BackpressurePolicy policy);
+    BackpressurePolicy GetBackpressurePolicy() const;
+
+    size_t GetQueueDepth() const { return m_queue.SizeApprox(); }
+    uint64_t GetDroppedCount() const { return m_droppedEvents.load(std::memory_order_relaxed); }
+    uint64_t GetCoalescedCount() const { return m_coalescedEvents.load(std::memory_order_relaxed); }
+    ProducerContention GetContention() const;
+
+private:
+    void SenderLoop();
+    void HandleEvent(const InputEvent& event);
+    void NotifyFlushWaiters();
+    void PushBlocking(const InputEvent& event);
+    void CoalesceMotion(const InputEvent& event);
+    bool TakeCoalescedMotion(InputEvent& event);
+    void WakeSender();
+    void WakeBlockedProducers();
+
+    EventHandler m_handler;
+    InputQueue m_queue;
+    std::atomic<BackpressurePolicy> m_policy;
+
+    std::thread m_senderThread;
+    std::atomic<bool> m_running{ false };
+
+    // Sender sleeps here when the queue is empty.
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wakeCondition;
+    std::atomic<bool> m_senderSleeping{ false };
+
+    // Producers waiting for room park here; the sender signals after popping.
+    static constexpr auto m_blockedRecheckInterval = std::chrono::milliseconds(10);
+    std::mutex m_roomMutex;
+    std::condition_variable m_roomCondition;
+    std::atomic<int> m_blockedProducers{ 0 };
+
+    // Flush() waits here for m_handledEvents to catch up.
+    std::mutex m_flushMutex;
+    std::condition_variable m_flushCondition;
+    std::atomic<uint64_t> m_submittedEvents{ 0 };
+    std::atomic<uint64_t> m_handledEvents{ 0 };
+    std::atomic<int> m_flushWaiters{ 0 };
+
+    // Motion merged while the queue was full (Coalesce policy).
+    std::mutex m_coalesceMutex;
+    std::atomic<bool> m_hasCoalescedMotion{ false };
+    std::atomic<int> m_coalescedInFlight{ 0 };
+    InputEvent m_coalescedMotion = InputEvent::MouseMove(0, 0, 0);
+
+    std::atomic<uint64_t> m_droppedEvents{ 0 };
+    std::atomic<uint64_t> m_coalescedEvents{ 0 };
+    std::atomic<uint64_t> m_blockedSubmissions{ 0 };
+    std::atomic<uint64_t> m_blockedNanoseconds{ 0 };
+};
+
+#endif // INPUT_DISPATCHER_H
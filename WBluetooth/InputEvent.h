@@ -0,0 +1,125 @@
+#ifndef INPUT_EVENT_H
+#define INPUT_EVENT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+enum class InputEventType : uint8_t
+{
+    MouseMove,
+    MousePress,     // scanCode holds the MouseButton mask
+    MouseRelease,   // scanCode holds the MouseButton mask
+    MouseClick,     // scanCode holds the MouseButton mask
+    KeyPress,
+    KeyRelease,
+    TypeText,       // scanCode holds the id of a compiled report sequence
+    MouseTrajectory,// scanCode holds the id of a compiled motion sequence
+    AbsoluteMove,   // dx, dy hold screen coordinates
+    TouchDown,      // dx, dy hold screen coordinates
+    TouchUp,
+    Tap             // dx, dy hold screen coordinates
+};
+
+// Mouse buttons as a bitmask, in HID button order. The standard mouse profile
+// only reports Left and Right.
+namespace MouseButton
+{
+    constexpr uint8_t Left = 0x01;
+    constexpr uint8_t Right = 0x02;
+    constexpr uint8_t Middle = 0x04;
+    constexpr uint8_t Back = 0x08;
+    constexpr uint8_t Forward = 0x10;
+}
+
+// What a producer does when the input queue is full.
+enum class BackpressurePolicy : uint8_t
+{
+    Block,      // wait for the sender thread to make room
+    DropOldest, // discard the oldest queued event if it is motion, else wait
+    Coalesce    // merge mouse motion into a pending delta, block for anything else
+};
+
+// Outcome of a batch handed to BleEmulator::SubmitEvents().
+enum class SubmitStatus : uint8_t
+{
+    Ok,
+    Dropped,        // queued, but DropOldest discarded older events to make room
+    InvalidEvent,   // nothing queued: an event has an unknown or process-local type
+    NotInitialized  // nothing queued: Initialize() has not been called
+};
+
+// One public input call, as queued for the sender thread.
+//
+// Also the element of the packed arrays BleEmulator::SubmitEvents() takes
+// from other languages, so the layout is fixed at 32 bytes, little-endian:
+//
+//   offset  0  uint8   type (InputEventType)
+//   offset  1  3 padding bytes, ignored
+//   offset  4  int32   dx
+//   offset  8  int32   dy
+//   offset 12  int32   wheel
+//   offset 16  uint32  scanCode
+//   offset 20  int32   pan
+//   offset 24  uint64  timestamp, 0 to have it stamped on submission
+struct InputEvent
+{
+    InputEventType type;
+    int32_t dx;
+    int32_t dy;
+    int32_t wheel;
+    uint32_t scanCode;
+    int32_t pan;        // horizontal scroll, MouseMove only
+    // When the public call was made (see InputLatency.h); set on submission.
+    uint64_t timestamp = 0;
+
+    static InputEvent MouseMove(int dx, int dy, int wheel, int pan = 0) { return { InputEventType::MouseMove, dx, dy, wheel, 0, pan }; }
+    static InputEvent MousePress(uint8_t buttons = MouseButton::Left) { return { InputEventType::MousePress, 0, 0, 0, buttons, 0 }; }
+    static InputEvent MouseRelease(uint8_t buttons = MouseButton::Left) { return { InputEventType::MouseRelease, 0, 0, 0, buttons, 0 }; }
+    static InputEvent MouseClick(uint8_t buttons = MouseButton::Left) { return { InputEventType::MouseClick, 0, 0, 0, buttons, 0 }; }
+    static InputEvent KeyPress(uint32_t scanCode) { return { InputEventType::KeyPress, 0, 0, 0, scanCode, 0 }; }
+    static InputEvent KeyRelease(uint32_t scanCode) { return { InputEventType::KeyRelease, 0, 0, 0, scanCode, 0 }; }
+    static InputEvent TypeText(uint32_t sequenceId) { return { InputEventType::TypeText, 0, 0, 0, sequenceId, 0 }; }
+    static InputEvent MouseTrajectory(uint32_t sequenceId) { return { InputEventType::MouseTrajectory, 0, 0, 0, sequenceId, 0 }; }
+    static InputEvent AbsoluteMove(int x, int y) { return { InputEventType::AbsoluteMove, x, y, 0, 0, 0 }; }
+    static InputEvent TouchDown(int x, int y) { return { InputEventType::TouchDown, x, y, 0, 0, 0 }; }
+    static InputEvent TouchUp() { return { InputEventType::TouchUp, 0, 0, 0, 0, 0 }; }
+    static InputEvent Tap(int x, int y) { return { InputEventType::Tap, x, y, 0, 0, 0 }; }
+};
+static_assert(std::is_standard_layout_v<InputEvent> && std::is_trivially_copyable_v<InputEvent>,
+    "InputEvent is passed as raw memory across language boundaries");
+static_assert(sizeof(InputEvent) == 32, "InputEvent layout is part of the interface");
+static_assert(offsetof(InputEvent, type) == 0 && offsetof(InputEvent, dx) == 4 && offsetof(InputEvent, dy) == 8 &&
+    offsetof(InputEvent, wheel) == 12 && offsetof(InputEvent, scanCode) == 16 && offsetof(InputEvent, pan) == 20 &&
+    offsetof(InputEvent, timestamp) == 24, "InputEvent layout is part of the interface");
+
+// False for unknown types and for TypeText / MouseTrajectory, whose sequence
+// ids only mean something inside the emulator that compiled them.
+inline bool IsPortableEventType(InputEventType type)
+{
+    switch (type)
+    {
+    case InputEventType::MouseMove:
+    case InputEventType::MousePress:
+    case InputEventType::MouseRelease:
+    case InputEventType::MouseClick:
+    case InputEventType::KeyPress:
+    case InputEventType::KeyRelease:
+    case InputEventType::AbsoluteMove:
+    case InputEventType::TouchDown:
+    case InputEventType::TouchUp:
+    case InputEventType::Tap:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Pointer motion, which later motion supersedes: the only events that
+// backpressure may discard without leaving a key or button held on the host.
+inline bool IsMotionEventType(InputEventType type)
+{
+    return type == InputEventType::MouseMove || type == InputEventType::AbsoluteMove;
+}
+
+#endif // INPUT_EVENT_H
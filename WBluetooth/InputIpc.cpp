@@ -0,0 +1,28 @@
+#include "InputIpc.h"
+#include <cstdlib>
+
+#if defined(_WIN32)
+#include <windows.h>
+#endif
+
+std::string InputIpc::RingName(const std::string& name)
+{
+#if defined(_WIN32)
+    return "Local\\WBluetooth-" + name;
+#else
+    return "/wbluetooth-" + name;
+#endif
+}
+
+std::string InputIpc::SocketPath(const std::string& name)
+{
+#if defined(_WIN32)
+    char directory[MAX_PATH + 1] = {};
+    if (GetTempPathA(sizeof(directory), directory) == 0)
+        directory[0] = '\0';
+    return std::string(directory) + "wbluetooth-" + name + ".sock";
+#else
+    const char* directory = std::getenv("XDG_RUNTIME_DIR");
+    return std::string(directory ? directory : "/tmp") + "/wbluetooth-" + name + ".sock";
+#endif
+}
@@ -0,0 +1,108 @@
+#ifndef INPUT_IPC_H
+#define INPUT_IPC_H
+
+#include "InputEvent.h"
+#include <cstdint>
+#include <string>
+
+// Wire format shared by InputServer (in the emulator process) and InputClient
+// (in capture or automation processes) on the same machine.
+//
+// Events travel as fixed 32-byte records, either through a shared-memory
+// ring (one record per event, no system call while the daemon is awake) or
+// in batches over a local control socket. Every socket message starts with
+// a MessageHeader and is answered with one Reply:
+//
+//   Events   payload is count records; reply count is how many were taken
+//   Text     payload is UTF-8 text to type; reply count is unmapped characters
+//   Flush    no payload; answered once everything sent before has gone out
+//
+// Socket messages take effect after the events the ring held when they
+// arrived, so a client may mix both channels without reordering.
+namespace InputIpc
+{
+    constexpr uint32_t m_magic = 0x43504957;   // "WIPC" little-endian
+    constexpr uint32_t m_version = 1;
+    constexpr size_t m_defaultRingCapacity = 4096;
+    constexpr size_t m_maxRingCapacity = 1 << 20;
+    constexpr size_t m_maxMessagePayloadSizeInBytes = 64 * 1024;
+
+    struct WireEvent
+    {
+        uint8_t type;           // InputEventType
+        uint8_t reserved[3];
+        int32_t dx;
+        int32_t dy;
+        int32_t wheel;
+        uint32_t scanCode;
+        int32_t pan;
+        uint64_t timestamp;     // steady_clock nanoseconds, see InputLatency.h; 0 if unknown
+    };
+    static_assert(sizeof(WireEvent) == 32, "WireEvent is part of the wire format");
+
+    constexpr size_t m_maxEventsPerMessage = m_maxMessagePayloadSizeInBytes / sizeof(WireEvent);
+
+    enum class MessageType : uint32_t
+    {
+        Events = 1,
+        Text = 2,
+        Flush = 3
+    };
+
+    enum class Status : uint32_t
+    {
+        Ok = 0,
+        Invalid = 1,        // malformed message or event; nothing of it was taken
+        Dropped = 2,        // taken, but mouse motion was discarded to keep up
+        Unavailable = 3     // the emulator is not initialized; nothing was taken
+    };
+
+    struct MessageHeader
+    {
+        uint32_t magic;
+        uint32_t type;          // MessageType
+        uint32_t size;          // payload bytes that follow
+        uint32_t reserved;
+    };
+
+    struct Reply
+    {
+        uint32_t status;        // Status
+        uint32_t count;
+    };
+
+    inline WireEvent ToWire(const InputEvent& event)
+    {
+        WireEvent wire{};
+        wire.type = static_cast<uint8_t>(event.type);
+        wire.dx = event.dx;
+        wire.dy = event.dy;
+        wire.wheel = event.wheel;
+        wire.scanCode = event.scanCode;
+        wire.pan = event.pan;
+        wire.timestamp = event.timestamp;
+        return wire;
+    }
+
+    // False for event types that cannot cross processes (see IsPortableEventType).
+    inline bool FromWire(const WireEvent& wire, InputEvent& event)
+    {
+        if (!IsPortableEventType(static_cast<InputEventType>(wire.type)))
+            return false;
+        event.type = static_cast<InputEventType>(wire.type);
+        event.dx = wire.dx;
+        event.dy = wire.dy;
+        event.wheel = wire.wheel;
+        event.scanCode = wire.scanCode;
+        event.pan = wire.pan;
+        event.timestamp = wire.timestamp;
+        return true;
+    }
+
+    // Name of the shared-memory ring, and path of the control socket, for a
+    // daemon started under name.
+    std::string RingName(const std::string& name);
+    std::string SocketPath(const std::string& name);
+}
+
+#endif // INPUT_IPC_H
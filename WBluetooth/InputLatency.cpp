@@ -0,0 +1,105 @@
+#include "InputLatency.h"
+
+namespace
+{
+    thread_local uint64_t g_currentOrigin = 0;
+
+    std::chrono::nanoseconds Between(uint64_t from, uint64_t to)
+    {
+        return std::chrono::nanoseconds(to > from ? static_cast<int64_t>(to - from) : 0);
+    }
+}
+
+uint64_t ReportOrigin::Now()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+uint64_t ReportOrigin::Current()
+{
+    return g_currentOrigin;
+}
+
+ReportOrigin::Scope::Scope(uint64_t origin)
+    : m_previous(g_currentOrigin)
+{
+    g_currentOrigin = origin;
+}
+
+ReportOrigin::Scope::~Scope()
+{
+    g_currentOrigin = m_previous;
+}
+
+InputLatencyStats::InputLatencyStats()
+    : m_startTime(ReportOrigin::Now())
+{
+}
+
+void InputLatencyStats::RecordDispatch(uint64_t origin)
+{
+    if (origin != 0)
+        m_dispatch.Record(Between(origin, ReportOrigin::Now()));
+}
+
+void InputLatencyStats::RecordTransmit(HidReportId reportId, uint64_t origin, uint64_t start, uint64_t end)
+{
+    auto& histograms = m_reports[static_cast<size_t>(reportId) % m_reportIdCount];
+    histograms.transmit.Record(Between(start, end));
+    if (origin != 0)
+    {
+        histograms.queued.Record(Between(origin, start));
+        histograms.endToEnd.Record(Between(origin, end));
+    }
+    m_reportCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+void InputLatencyStats::RecordTransmitFailure(HidReportId reportId)
+{
+    m_reports[static_cast<size_t>(reportId) % m_reportIdCount].failed.fetch_add(1, std::memory_order_relaxed);
+}
+
+ReportLatency InputLatencyStats::GetReportLatency(HidReportId reportId) const
+{
+    const auto& histograms = m_reports[static_cast<size_t>(reportId) % m_reportIdCount];
+    return { histograms.queued.Summarize(), histograms.transmit.Summarize(), histograms.endToEnd.Summarize(),
+        histograms.failed.load(std::memory_order_relaxed) };
+}
+
+std::chrono::nanoseconds InputLatencyStats::GetElapsed() const
+{
+    return Between(m_startTime.load(std::memory_order_relaxed), ReportOrigin::Now());
+}
+
+void InputLatencyStats::Reset()
+{
+    m_dispatch.Reset();
+    for (auto& histograms : m_reports)
+    {
+        histograms.queued.Reset();
+        histograms.transmit.Reset();
+        histograms.endToEnd.Reset();
+        histograms.failed.store(0, std::memory_order_relaxed);
+    }
+    m_reportCount.store(0, std::memory_order_relaxed);
+    m_startTime.store(ReportOrigin::Now(), std::memory_order_relaxed);
+}
+
+LatencyProbeSink::LatencyProbeSink(HidReportSink& inner, InputLatencyStats& stats)
+    : m_inner(inner)
+    , m_stats(stats)
+{
+}
+
+bool LatencyProbeSink::IsReady(HidReportId reportId) const
+{
+    return m_inner.IsReady(reportId);
+}
+
+void LatencyProbeSink::SendReport(HidReportId reportId, const uint8_t* data, size_t size)
+{
+    uint64_t start = ReportOrigin::Now();
+    m_inner.SendReport(reportId, data, size);
+    m_stats.RecordTransmit(reportId, ReportOrigin::Current(), start, ReportOrigin::Now());
+}
@@ -0,0 +1,92 @@
+#ifndef INPUT_LATENCY_H
+#define INPUT_LATENCY_H
+
+#include "HidReportSink.h"
+#include "LatencyHistogram.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// Time stamps along the input path are steady_clock nanoseconds; 0 means unknown.
+//
+// The time of the public input call a report stems from travels with it as
+// the "origin": whoever builds or forwards reports opens a Scope with it on
+// the thread that calls the next sink, and components that queue reports
+// (scheduler, fan-out) store Current() alongside them.
+namespace ReportOrigin
+{
+    uint64_t Now();
+    uint64_t Current();
+
+    class Scope
+    {
+    public:
+        explicit Scope(uint64_t origin);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        uint64_t m_previous;
+    };
+}
+
+// Latency histograms for the whole input path, per report ID where reports
+// are involved. Recording is lock-free and cheap enough to leave on.
+class InputLatencyStats
+{
+public:
+    InputLatencyStats();
+
+    InputLatencyStats(const InputLatencyStats&) = delete;
+    InputLatencyStats& operator=(const InputLatencyStats&) = delete;
+
+    // The sender thread picked up an event submitted at origin.
+    void RecordDispatch(uint64_t origin);
+    // A transport took from start to end to send a report stemming from origin.
+    void RecordTransmit(HidReportId reportId, uint64_t origin, uint64_t start, uint64_t end);
+    // A transport gave up on a report, or the central never acknowledged it.
+    void RecordTransmitFailure(HidReportId reportId);
+
+    LatencySummary GetDispatchLatency() const { return m_dispatch.Summarize(); }
+    ReportLatency GetReportLatency(HidReportId reportId) const;
+    uint64_t GetReportCount() const { return m_reportCount.load(std::memory_order_relaxed); }
+    // Time since construction or the last Reset().
+    std::chrono::nanoseconds GetElapsed() const;
+
+    void Reset();
+
+private:
+    static constexpr size_t m_reportIdCount = HidReportIdCount;
+
+    struct ReportHistograms {
+        LatencyHistogram queued;
+        LatencyHistogram transmit;
+        LatencyHistogram endToEnd;
+        std::atomic<uint64_t> failed{ 0 };
+    };
+
+    LatencyHistogram m_dispatch;
+    std::array<ReportHistograms, m_reportIdCount> m_reports;
+    std::atomic<uint64_t> m_reportCount{ 0 };
+    std::atomic<uint64_t> m_startTime{ 0 };
+};
+
+// Sink decorator at the transport boundary: times each SendReport() on the
+// inner sink, which is taken to be done with the report when it returns.
+class LatencyProbeSink : public HidReportSink
+{
+public:
+    LatencyProbeSink(HidReportSink& inner, InputLatencyStats& stats);
+
+    bool IsReady(HidReportId reportId) const override;
+    void SendReport(HidReportId reportId, const uint8_t* data, size_t size) override;
+
+private:
+    HidReportSink& m_inner;
+    InputLatencyStats& m_stats;
+};
+
+#endif // INPUT_LATENCY_H
@@ -0,0 +1,160 @@
+#include "InputQueue.h"
+
+static size_t RoundUpToPowerOfTwo(size_t value)
+{
+    size_t result = 2;
+    while (result < value)
+        result <<= 1;
+    return result;
+}
+
+InputQueue::InputQueue(size_t capacity)
+{
+    size_t size = RoundUpToPowerOfTwo(capacity);
+    m_cells = std::make_unique<Cell[]>(size);
+    m_mask = size - 1;
+    for (size_t i = 0; i < size; ++i)
+        m_cells[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+bool InputQueue::TryPush(const InputEvent& event)
+{
+    size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        Cell& cell = m_cells[pos & m_mask];
+        size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+        if (diff == 0)
+        {
+            if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                cell.event = event;
+                cell.type.store(event.type, std::memory_order_relaxed);
+                cell.sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+            m_pushRetries.fetch_add(1, std::memory_order_relaxed);
+        }
+        else if (diff < 0)
+        {
+            m_pushFull.fetch_add(1, std::memory_order_relaxed);
+            return false; // full
+        }
+        else
+        {
+            m_pushRetries.fetch_add(1, std::memory_order_relaxed);
+            pos = m_enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+size_t InputQueue::TryPushBatch(const InputEvent* events, size_t count, uint64_t timestamp)
+{
+    size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        // Free cells only stop being free when a producer claims them, and
+        // claiming goes through m_enqueuePos: if the CAS below succeeds, the
+        // whole run counted here is still ours.
+        size_t run = 0;
+        while (run < count && m_cells[(pos + run) & m_mask].sequence.load(std::memory_order_acquire) == pos + run)
+            ++run;
+
+        if (run == 0)
+        {
+            size_t sequence = m_cells[pos & m_mask].sequence.load(std::memory_order_acquire);
+            if (static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos) < 0)
+            {
+                m_pushFull.fetch_add(1, std::memory_order_relaxed);
+                return 0; // full
+            }
+            m_pushRetries.fetch_add(1, std::memory_order_relaxed);
+            pos = m_enqueuePos.load(std::memory_order_relaxed);
+            continue;
+        }
+
+        if (m_enqueuePos.compare_exchange_weak(pos, pos + run, std::memory_order_relaxed))
+        {
+            // Published in order, so the consumer never waits on a hole.
+            for (size_t i = 0; i < run; ++i)
+            {
+                Cell& cell = m_cells[(pos + i) & m_mask];
+                cell.event = events[i];
+                if (timestamp != 0)
+                    cell.event.timestamp = timestamp;
+                cell.type.store(events[i].type, std::memory_order_relaxed);
+                cell.sequence.store(pos + i + 1, std::memory_order_release);
+            }
+            return run;
+        }
+        m_pushRetries.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+bool InputQueue::TryPop(InputEvent& event)
+{
+    size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        Cell& cell = m_cells[pos & m_mask];
+        size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+        if (diff == 0)
+        {
+            if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                event = cell.event;
+                cell.sequence.store(pos + m_mask + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (diff < 0)
+        {
+            return false; // empty
+        }
+        else
+        {
+            pos = m_dequeuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool InputQueue::TryPopIf(InputEvent& event, bool (*accept)(InputEventType type))
+{
+    size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        Cell& cell = m_cells[pos & m_mask];
+        size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+        if (diff == 0)
+        {
+            // The type can only change once another consumer has moved
+            // m_dequeuePos past pos, which makes the claim below fail.
+            if (!accept(cell.type.load(std::memory_order_relaxed)))
+                return false;
+            if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                event = cell.event;
+                cell.sequence.store(pos + m_mask + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (diff < 0)
+        {
+            return false; // empty
+        }
+        else
+        {
+            pos = m_dequeuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+size_t InputQueue::SizeApprox() const
+{
+    size_t enqueued = m_enqueuePos.load(std::memory_order_relaxed);
+    size_t dequeued = m_dequeuePos.load(std::memory_order_relaxed);
+    return enqueued > dequeued ? enqueued - dequeued : 0;
+}
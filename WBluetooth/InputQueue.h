@@ -0,0 +1,59 @@
+#ifndef INPUT_QUEUE_H
+#define INPUT_QUEUE_H
+
+#include "InputEvent.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Bounded lock-free multi-producer/multi-consumer ring of input events.
+// Each cell carries a sequence number that tells producers and consumers
+// whether the cell is free or published for the current lap.
+class InputQueue
+{
+public:
+    // Capacity is rounded up to a power of two.
+    explicit InputQueue(size_t capacity);
+
+    InputQueue(const InputQueue&) = delete;
+    InputQueue& operator=(const InputQueue&) = delete;
+
+    bool TryPush(const InputEvent& event);
+    // Claims room for as many of the events as fit with a single atomic step
+    // and returns how many were queued. A nonzero timestamp replaces theirs.
+    size_t TryPushBatch(const InputEvent* events, size_t count, uint64_t timestamp = 0);
+    bool TryPop(InputEvent& event);
+    // Pops the oldest event only if accept(its type) holds.
+    bool TryPopIf(InputEvent& event, bool (*accept)(InputEventType type));
+
+    size_t Capacity() const { return m_mask + 1; }
+    // Pushes that lost a cell to another producer and went round again, and
+    // pushes turned away because the queue was full.
+    uint64_t GetRetryCount() const { return m_pushRetries.load(std::memory_order_relaxed); }
+    uint64_t GetFullCount() const { return m_pushFull.load(std::memory_order_relaxed); }
+    size_t SizeApprox() const;
+    bool Empty() const { return SizeApprox() == 0; }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        // Copy of event.type that TryPopIf can read before claiming the cell.
+        std::atomic<InputEventType> type;
+        InputEvent event;
+    };
+
+    static constexpr size_t m_cacheLineSize = 64;
+
+    std::unique_ptr<Cell[]> m_cells;
+    size_t m_mask = 0;
+
+    alignas(m_cacheLineSize) std::atomic<size_t> m_enqueuePos{ 0 };
+    alignas(m_cacheLineSize) std::atomic<size_t> m_dequeuePos{ 0 };
+
+    // Only touched on the slow paths, away from the positions.
+    alignas(m_cacheLineSize) std::atomic<uint64_t> m_pushRetries{ 0 };
+    std::atomic<uint64_t> m_pushFull{ 0 };
+};
+
+#endif // INPUT_QUEUE_H
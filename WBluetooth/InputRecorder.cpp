@@ -0,0 +1,163 @@
+#include "InputRecorder.h"
+#include "InputTrace.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+InputRecorder::~InputRecorder()
+{
+    Close();
+}
+
+bool InputRecorder::Open(const std::string& path)
+{
+    std::scoped_lock lock(m_mutex);
+    if (m_file.is_open())
+        return false;
+
+    std::array<char, InputTrace::m_headerSizeInBytes> header{};
+    std::ifstream existing(path, std::ios::binary);
+    bool hasHeader = existing.read(header.data(), header.size()).gcount() == static_cast<std::streamsize>(header.size());
+    if (existing.gcount() > 0 && !hasHeader)
+        return false;
+    if (hasHeader &&
+        (!std::equal(std::begin(InputTrace::m_magic), std::end(InputTrace::m_magic), header.begin()) ||
+         static_cast<uint8_t>(header[4]) != InputTrace::m_version))
+        return false;
+    existing.close();
+
+    m_file.open(path, std::ios::binary | std::ios::app);
+    if (!m_file.is_open())
+        return false;
+
+    if (!hasHeader) {
+        header.fill(0);
+        std::copy(std::begin(InputTrace::m_magic), std::end(InputTrace::m_magic), header.begin());
+        header[4] = static_cast<char>(InputTrace::m_version);
+        m_file.write(header.data(), header.size());
+    }
+
+    // The first record of an appended session starts right after the previous one.
+    m_hasLastRecordTime = false;
+    m_open.store(true, std::memory_order_release);
+    return true;
+}
+
+void InputRecorder::Close()
+{
+    std::scoped_lock lock(m_mutex);
+    m_open.store(false, std::memory_order_release);
+    if (m_file.is_open())
+        m_file.close();
+}
+
+size_t InputRecorder::BeginRecord(InputEventType type, uint8_t* out)
+{
+    auto now = std::chrono::steady_clock::now();
+    uint64_t delay = 0;
+    if (m_hasLastRecordTime)
+        delay = std::chrono::duration_cast<std::chrono::microseconds>(now - m_lastRecordTime).count();
+    m_lastRecordTime = now;
+    m_hasLastRecordTime = true;
+
+    out[0] = static_cast<uint8_t>(type);
+    return 1 + InputTrace::EncodeVarint(delay, out + 1);
+}
+
+void InputRecorder::Record(const InputEvent& event)
+{
+    Record(&event, 1);
+}
+
+void InputRecorder::Record(const InputEvent* events, size_t count)
+{
+    if (!IsOpen())
+        return;
+
+    std::scoped_lock lock(m_mutex);
+    if (!m_file.is_open())
+        return;
+
+    for (size_t i = 0; i < count; ++i)
+        WriteEvent(events[i]);
+}
+
+void InputRecorder::WriteEvent(const InputEvent& event)
+{
+    if (event.type == InputEventType::TypeText || event.type == InputEventType::MouseTrajectory)
+        return;
+
+    std::array<uint8_t, 1 + 5 * InputTrace::m_maxVarintSizeInBytes> buffer;
+    size_t size = BeginRecord(event.type, buffer.data());
+    switch (event.type) {
+    case InputEventType::MouseMove:
+        size += InputTrace::EncodeVarint(InputTrace::ZigZag(event.dx), buffer.data() + size);
+        size += InputTrace::EncodeVarint(InputTrace::ZigZag(event.dy), buffer.data() + size);
+        size += InputTrace::EncodeVarint(InputTrace::ZigZag(event.wheel), buffer.data() + size);
+        size += InputTrace::EncodeVarint(InputTrace::ZigZag(event.pan), buffer.data() + size);
+        break;
+    case InputEventType::MousePress:
+    case InputEventType::MouseRelease:
+    case InputEventType::MouseClick:
+    case InputEventType::KeyPress:
+    case InputEventType::KeyRelease:
+        size += InputTrace::EncodeVarint(event.scanCode, buffer.data() + size);
+        break;
+    case InputEventType::AbsoluteMove:
+    case InputEventType::TouchDown:
+    case InputEventType::Tap:
+        size += InputTrace::EncodeVarint(InputTrace::ZigZag(event.dx), buffer.data() + size);
+        size += InputTrace::EncodeVarint(InputTrace::ZigZag(event.dy), buffer.data() + size);
+        break;
+    default:
+        break;
+    }
+
+    m_file.write(reinterpret_cast<const char*>(buffer.data()), size);
+    m_recordCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+void InputRecorder::RecordText(const std::u32string& text)
+{
+    if (!IsOpen() || text.empty())
+        return;
+
+    std::vector<uint8_t> buffer((2 + text.size()) * InputTrace::m_maxVarintSizeInBytes + 1);
+
+    std::scoped_lock lock(m_mutex);
+    if (!m_file.is_open())
+        return;
+
+    size_t size = BeginRecord(InputEventType::TypeText, buffer.data());
+    size += InputTrace::EncodeVarint(text.size(), buffer.data() + size);
+    for (char32_t ch : text)
+        size += InputTrace::EncodeVarint(ch, buffer.data() + size);
+
+    m_file.write(reinterpret_cast<const char*>(buffer.data()), size);
+    m_recordCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+void InputRecorder::RecordPath(const PointerPath& path)
+{
+    if (!IsOpen())
+        return;
+
+    std::vector<uint8_t> buffer((4 + 2 * path.points.size()) * InputTrace::m_maxVarintSizeInBytes + 1);
+
+    std::scoped_lock lock(m_mutex);
+    if (!m_file.is_open())
+        return;
+
+    size_t size = BeginRecord(InputEventType::MouseTrajectory, buffer.data());
+    size += InputTrace::EncodeVarint(static_cast<uint64_t>(path.shape), buffer.data() + size);
+    size += InputTrace::EncodeVarint(static_cast<uint64_t>(path.duration.count()), buffer.data() + size);
+    size += InputTrace::EncodeVarint(path.points.size(), buffer.data() + size);
+    for (const auto& point : path.points) {
+        size += InputTrace::EncodeVarint(InputTrace::ZigZag(std::llround(point.x * InputTrace::m_pathPointScale)), buffer.data() + size);
+        size += InputTrace::EncodeVarint(InputTrace::ZigZag(std::llround(point.y * InputTrace::m_pathPointScale)), buffer.data() + size);
+    }
+
+    m_file.write(reinterpret_cast<const char*>(buffer.data()), size);
+    m_recordCount.fetch_add(1, std::memory_order_relaxed);
+}
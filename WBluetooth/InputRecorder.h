@@ -0,0 +1,51 @@
+#ifndef INPUT_RECORDER_H
+#define INPUT_RECORDER_H
+
+#include "InputEvent.h"
+#include "PointerTrajectory.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+
+// Appends public input calls with their timing to a binary trace (see InputTrace.h).
+// Safe to call from several producer threads; records keep call order.
+class InputRecorder
+{
+public:
+    InputRecorder() = default;
+    ~InputRecorder();
+
+    // Appends to an existing trace, or starts a new one. Returns false if the
+    // file cannot be opened or is not a trace of this format.
+    bool Open(const std::string& path);
+    void Close();
+    bool IsOpen() const { return m_open.load(std::memory_order_acquire); }
+
+    void Record(const InputEvent& event);
+    // Takes the lock once for the whole batch.
+    void Record(const InputEvent* events, size_t count);
+    void RecordText(const std::u32string& text);
+    void RecordPath(const PointerPath& path);
+
+    uint64_t GetRecordCount() const { return m_recordCount.load(std::memory_order_relaxed); }
+
+private:
+    // Writes type and delay; the caller appends the payload.
+    size_t BeginRecord(InputEventType type, uint8_t* out);
+    // Caller holds m_mutex.
+    void WriteEvent(const InputEvent& event);
+
+    std::atomic<bool> m_open{ false };
+    std::atomic<uint64_t> m_recordCount{ 0 };
+
+    std::mutex m_mutex;
+    std::ofstream m_file;
+    std::chrono::steady_clock::time_point m_lastRecordTime;
+    bool m_hasLastRecordTime = false;
+};
+
+#endif // INPUT_RECORDER_H
@@ -0,0 +1,237 @@
+#include "InputReplayer.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <thread>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+InputReplayer::~InputReplayer()
+{
+    Close();
+}
+
+bool InputReplayer::Open(const std::string& path)
+{
+    Close();
+
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+        OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(file, &size) || size.QuadPart < static_cast<LONGLONG>(InputTrace::m_headerSizeInBytes)) {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view) {
+        if (mapping)
+            CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    m_file = file;
+    m_mapping = mapping;
+    m_data = static_cast<const uint8_t*>(view);
+    m_size = static_cast<size_t>(size.QuadPart);
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat status {};
+    if (fstat(fd, &status) != 0 || status.st_size < static_cast<off_t>(InputTrace::m_headerSizeInBytes)) {
+        close(fd);
+        return false;
+    }
+
+    void* view = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping keeps the file alive.
+    close(fd);
+    if (view == MAP_FAILED)
+        return false;
+    madvise(view, static_cast<size_t>(status.st_size), MADV_SEQUENTIAL);
+
+    m_data = static_cast<const uint8_t*>(view);
+    m_size = static_cast<size_t>(status.st_size);
+#endif
+
+    if (!std::equal(std::begin(InputTrace::m_magic), std::end(InputTrace::m_magic), m_data) ||
+        m_data[4] < InputTrace::m_oldestReadableVersion || m_data[4] > InputTrace::m_version) {
+        Close();
+        return false;
+    }
+    m_version = m_data[4];
+    return true;
+}
+
+void InputReplayer::Close()
+{
+#if defined(_WIN32)
+    if (m_data)
+        UnmapViewOfFile(m_data);
+    if (m_mapping)
+        CloseHandle(m_mapping);
+    if (m_file)
+        CloseHandle(m_file);
+    m_mapping = nullptr;
+    m_file = nullptr;
+#else
+    if (m_data)
+        munmap(const_cast<uint8_t*>(m_data), m_size);
+#endif
+    m_data = nullptr;
+    m_size = 0;
+    m_version = 0;
+}
+
+bool InputReplayer::DecodeRecord(const uint8_t*& cursor, const uint8_t* end, InputTrace::Record& record,
+    uint8_t version)
+{
+    if (cursor >= end || *cursor > static_cast<uint8_t>(InputEventType::Tap))
+        return false;
+
+    auto type = static_cast<InputEventType>(*cursor++);
+    if (!InputTrace::DecodeVarint(cursor, end, record.delayMicroseconds))
+        return false;
+
+    record.event = { type, 0, 0, 0, 0, 0 };
+    record.text.clear();
+    record.path.points.clear();
+
+    uint64_t value = 0;
+    switch (type) {
+    case InputEventType::MouseMove: {
+        int32_t* fields[] = { &record.event.dx, &record.event.dy, &record.event.wheel, &record.event.pan };
+        for (size_t i = 0; i < (version >= 2 ? 4u : 3u); ++i) {
+            if (!InputTrace::DecodeVarint(cursor, end, value))
+                return false;
+            *fields[i] = static_cast<int32_t>(InputTrace::UnZigZag(value));
+        }
+        break;
+    }
+    case InputEventType::MousePress:
+    case InputEventType::MouseRelease:
+    case InputEventType::MouseClick:
+        record.event.scanCode = MouseButton::Left;
+        if (version >= 2) {
+            if (!InputTrace::DecodeVarint(cursor, end, value))
+                return false;
+            record.event.scanCode = static_cast<uint32_t>(value);
+        }
+        break;
+    case InputEventType::KeyPress:
+    case InputEventType::KeyRelease:
+        if (!InputTrace::DecodeVarint(cursor, end, value))
+            return false;
+        record.event.scanCode = static_cast<uint32_t>(value);
+        break;
+    case InputEventType::AbsoluteMove:
+    case InputEventType::TouchDown:
+    case InputEventType::Tap: {
+        int32_t* fields[] = { &record.event.dx, &record.event.dy };
+        for (int32_t* field : fields) {
+            if (!InputTrace::DecodeVarint(cursor, end, value))
+                return false;
+            *field = static_cast<int32_t>(InputTrace::UnZigZag(value));
+        }
+        break;
+    }
+    case InputEventType::TypeText: {
+        uint64_t length = 0;
+        // Every character takes at least one byte, which bounds a corrupt length.
+        if (!InputTrace::DecodeVarint(cursor, end, length) || length > static_cast<uint64_t>(end - cursor))
+            return false;
+        record.text.reserve(static_cast<size_t>(length));
+        for (uint64_t i = 0; i < length; ++i) {
+            if (!InputTrace::DecodeVarint(cursor, end, value))
+                return false;
+            record.text.push_back(static_cast<char32_t>(value));
+        }
+        break;
+    }
+    case InputEventType::MouseTrajectory: {
+        uint64_t shape = 0, duration = 0, count = 0;
+        if (!InputTrace::DecodeVarint(cursor, end, shape) || shape > static_cast<uint64_t>(PointerPathShape::Bezier) ||
+            !InputTrace::DecodeVarint(cursor, end, duration) ||
+            !InputTrace::DecodeVarint(cursor, end, count) || count > static_cast<uint64_t>(end - cursor) / 2)
+            return false;
+        record.path.shape = static_cast<PointerPathShape>(shape);
+        record.path.duration = std::chrono::microseconds(static_cast<int64_t>(duration));
+        record.path.points.reserve(static_cast<size_t>(count));
+        uint64_t x = 0, y = 0;
+        for (uint64_t i = 0; i < count; ++i) {
+            if (!InputTrace::DecodeVarint(cursor, end, x) || !InputTrace::DecodeVarint(cursor, end, y))
+                return false;
+            record.path.points.push_back({ InputTrace::UnZigZag(x) / InputTrace::m_pathPointScale,
+                                           InputTrace::UnZigZag(y) / InputTrace::m_pathPointScale });
+        }
+        break;
+    }
+    default:
+        break;
+    }
+    return true;
+}
+
+size_t InputReplayer::Play(const RecordHandler& handler, ReplayTiming timing) const
+{
+    return Play(handler, nullptr, timing);
+}
+
+size_t InputReplayer::Play(const RecordHandler& handler, const EventBatchHandler& batchHandler, ReplayTiming timing) const
+{
+    if (!m_data)
+        return 0;
+
+    const uint8_t* cursor = m_data + InputTrace::m_headerSizeInBytes;
+    const uint8_t* end = m_data + m_size;
+
+    std::array<InputEvent, m_maxBatchSize> batch;
+    size_t batched = 0;
+    auto flushBatch = [&] {
+        if (batched != 0)
+            batchHandler(batch.data(), batched);
+        batched = 0;
+    };
+
+    // Deadlines are taken from the start so sleep overshoot does not accumulate.
+    auto deadline = std::chrono::steady_clock::now();
+    InputTrace::Record record{};
+    size_t played = 0;
+    while (cursor < end && DecodeRecord(cursor, end, record, m_version)) {
+        if (timing == ReplayTiming::Original && record.delayMicroseconds != 0) {
+            // Whatever is batched was due before this gap.
+            flushBatch();
+            deadline += std::chrono::microseconds(record.delayMicroseconds);
+            std::this_thread::sleep_until(deadline);
+        }
+
+        bool plain = record.event.type != InputEventType::TypeText &&
+            record.event.type != InputEventType::MouseTrajectory;
+        if (batchHandler && plain) {
+            batch[batched++] = record.event;
+            if (batched == batch.size())
+                flushBatch();
+        } else {
+            flushBatch();
+            handler(record);
+        }
+        ++played;
+    }
+    flushBatch();
+    return played;
+}
@@ -0,0 +1,51 @@
+#ifndef INPUT_REPLAYER_H
+#define INPUT_REPLAYER_H
+
+#include "InputTrace.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+// Memory-maps a binary input trace (see InputTrace.h) and plays it back.
+class InputReplayer
+{
+public:
+    using RecordHandler = std::function<void(const InputTrace::Record&)>;
+    using EventBatchHandler = std::function<void(const InputEvent* events, size_t count)>;
+
+    static constexpr size_t m_maxBatchSize = 256;
+
+    InputReplayer() = default;
+    ~InputReplayer();
+
+    InputReplayer(const InputReplayer&) = delete;
+    InputReplayer& operator=(const InputReplayer&) = delete;
+
+    bool Open(const std::string& path);
+    void Close();
+    bool IsOpen() const { return m_data != nullptr; }
+
+    // Calls handler for every record, on schedule for ReplayTiming::Original.
+    // Returns the number of records played; stops early on a malformed record.
+    size_t Play(const RecordHandler& handler, ReplayTiming timing) const;
+    // Same, but runs of plain events that are due together (back to back, or
+    // all of them for AsFastAsPossible) go to batchHandler in one call;
+    // TypeText and MouseTrajectory records still go to handler.
+    size_t Play(const RecordHandler& handler, const EventBatchHandler& batchHandler, ReplayTiming timing) const;
+
+    // Decodes the record at cursor, written in trace format version, and advances past it.
+    static bool DecodeRecord(const uint8_t*& cursor, const uint8_t* end, InputTrace::Record& record,
+        uint8_t version = InputTrace::m_version);
+
+private:
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+    uint8_t m_version = 0;
+#if defined(_WIN32)
+    void* m_file = nullptr;
+    void* m_mapping = nullptr;
+#endif
+};
+
+#endif // INPUT_REPLAYER_H
@@ -0,0 +1,299 @@
+#include "InputServer.h"
+#include "EventLog.h"
+#include "InputLatency.h"
+#include "LocalSocket.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace
+{
+    constexpr auto m_idleWait = std::chrono::milliseconds(100);
+    constexpr auto m_catchUpTimeout = std::chrono::seconds(1);
+    constexpr size_t m_ringBatchSize = 256;
+    constexpr size_t m_receiveChunkSize = 16 * 1024;
+}
+
+InputServer::InputServer(Handlers handlers)
+    : m_handlers(std::move(handlers))
+{
+}
+
+InputServer::~InputServer()
+{
+    Stop();
+}
+
+bool InputServer::Start(const std::string& name, size_t ringCapacity)
+{
+    Stop();
+
+    if (!m_ring.Create(name, ringCapacity))
+    {
+        EventLog::WriteText(LogLevel::Error, "[InputServer] Cannot create the shared ring:", name.c_str());
+        return false;
+    }
+
+    m_socketPath = InputIpc::SocketPath(name);
+    m_listenSocket = LocalSocket::Listen(m_socketPath);
+    if (m_listenSocket == LocalSocket::m_invalid)
+    {
+        EventLog::WriteText(LogLevel::Error, "[InputServer] Cannot listen on:", m_socketPath.c_str());
+        m_ring.Close();
+        return false;
+    }
+
+    m_ringHandled = m_ring.GetDequeuePosition();
+    m_running.store(true, std::memory_order_release);
+    m_ringThread = std::thread(&InputServer::RingLoop, this);
+    m_socketThread = std::thread(&InputServer::SocketLoop, this);
+    return true;
+}
+
+void InputServer::Stop()
+{
+    if (!m_running.exchange(false))
+        return;
+
+    m_ring.Wake();
+    m_progressCondition.notify_all();
+    if (m_ringThread.joinable())
+        m_ringThread.join();
+    if (m_socketThread.joinable())
+        m_socketThread.join();
+
+    for (auto& connection : m_connections)
+        LocalSocket::Close(connection.socket);
+    m_connections.clear();
+    m_clients.store(0, std::memory_order_relaxed);
+    LocalSocket::Close(m_listenSocket);
+    m_listenSocket = LocalSocket::m_invalid;
+    LocalSocket::Unlink(m_socketPath);
+    m_ring.Close();
+}
+
+InputServerStats InputServer::GetStats() const
+{
+    InputServerStats stats{};
+    stats.ringEvents = m_ringEvents.load(std::memory_order_relaxed);
+    stats.socketEvents = m_socketEvents.load(std::memory_order_relaxed);
+    stats.rejectedEvents = m_rejectedEvents.load(std::memory_order_relaxed);
+    stats.lossyBatches = m_lossyBatches.load(std::memory_order_relaxed);
+    stats.messages = m_messages.load(std::memory_order_relaxed);
+    stats.clients = m_clients.load(std::memory_order_relaxed);
+    stats.transferLatency = m_transferLatency.Summarize();
+    return stats;
+}
+
+void InputServer::ResetStats()
+{
+    m_transferLatency.Reset();
+}
+
+SubmitStatus InputServer::Deliver(InputEvent* events, size_t count)
+{
+    // Producers stamp events on the same monotonic clock; anything else
+    // counts from pickup.
+    uint64_t now = ReportOrigin::Now();
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint64_t& timestamp = events[i].timestamp;
+        if (timestamp == 0 || timestamp > now)
+            timestamp = now;
+        else
+            m_transferLatency.Record(std::chrono::nanoseconds(now - timestamp));
+    }
+    if (count == 0)
+        return SubmitStatus::Ok;
+
+    SubmitStatus status = m_handlers.submit(events, count);
+    if (status != SubmitStatus::Ok)
+        m_lossyBatches.fetch_add(1, std::memory_order_relaxed);
+    return status;
+}
+
+void InputServer::RingLoop()
+{
+    std::array<InputEvent, m_ringBatchSize> batch;
+    while (m_running.load(std::memory_order_acquire))
+    {
+        size_t taken = 0;
+        {
+            std::scoped_lock lock(m_deliverMutex);
+            InputIpc::WireEvent wire;
+            size_t valid = 0;
+            while (taken < m_ringBatchSize && m_ring.TryPop(wire))
+            {
+                ++taken;
+                if (InputIpc::FromWire(wire, batch[valid]))
+                    ++valid;
+                else
+                    m_rejectedEvents.fetch_add(1, std::memory_order_relaxed);
+            }
+            Deliver(batch.data(), valid);
+        }
+
+        if (taken != 0)
+        {
+            m_ringEvents.fetch_add(taken, std::memory_order_relaxed);
+            {
+                std::scoped_lock lock(m_progressMutex);
+                m_ringHandled = m_ring.GetDequeuePosition();
+            }
+            m_progressCondition.notify_all();
+        }
+        else
+        {
+            m_ring.WaitForEvents(m_idleWait);
+        }
+    }
+}
+
+void InputServer::CatchUpWithRing()
+{
+    uint64_t target = m_ring.GetEnqueuePosition();
+    std::unique_lock lock(m_progressMutex);
+    if (m_ringHandled >= target)
+        return;
+
+    m_ring.Wake();
+    // A producer that died between claiming and filling a cell holds the
+    // ring up for good (see SharedInputRing.h); do not let it take the
+    // control socket down as well.
+    bool caughtUp = m_progressCondition.wait_for(lock, m_catchUpTimeout, [&] {
+        return m_ringHandled >= target || !m_running.load(std::memory_order_acquire);
+    });
+    if (!caughtUp)
+        EventLog::Write(LogLevel::Warning, "[InputServer] The shared ring is stuck behind an unfinished event; restart the daemon if it stays so");
+}
+
+InputIpc::Reply InputServer::HandleMessage(const InputIpc::MessageHeader& header, const uint8_t* payload)
+{
+    InputIpc::Reply reply{ static_cast<uint32_t>(InputIpc::Status::Ok), 0 };
+    switch (static_cast<InputIpc::MessageType>(header.type))
+    {
+    case InputIpc::MessageType::Events:
+    {
+        size_t count = header.size / sizeof(InputIpc::WireEvent);
+        if (header.size % sizeof(InputIpc::WireEvent) != 0)
+        {
+            reply.status = static_cast<uint32_t>(InputIpc::Status::Invalid);
+            break;
+        }
+
+        // All or nothing: check the whole batch before handing any of it on.
+        std::vector<InputEvent> events(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            InputIpc::WireEvent wire;
+            std::memcpy(&wire, payload + i * sizeof(wire), sizeof(wire));
+            if (!InputIpc::FromWire(wire, events[i]))
+            {
+                m_rejectedEvents.fetch_add(count, std::memory_order_relaxed);
+                reply.status = static_cast<uint32_t>(InputIpc::Status::Invalid);
+                return reply;
+            }
+        }
+
+        CatchUpWithRing();
+        std::scoped_lock lock(m_deliverMutex);
+        SubmitStatus status = Deliver(events.data(), count);
+        if (status == SubmitStatus::NotInitialized || status == SubmitStatus::InvalidEvent)
+        {
+            reply.status = static_cast<uint32_t>(InputIpc::Status::Unavailable);
+            break;
+        }
+        if (status == SubmitStatus::Dropped)
+            reply.status = static_cast<uint32_t>(InputIpc::Status::Dropped);
+        m_socketEvents.fetch_add(count, std::memory_order_relaxed);
+        reply.count = static_cast<uint32_t>(count);
+        break;
+    }
+    case InputIpc::MessageType::Text:
+    {
+        CatchUpWithRing();
+        std::scoped_lock lock(m_deliverMutex);
+        std::string text(reinterpret_cast<const char*>(payload), header.size);
+        reply.count = static_cast<uint32_t>(m_handlers.typeText(text));
+        break;
+    }
+    case InputIpc::MessageType::Flush:
+    {
+        CatchUpWithRing();
+        // Not under m_deliverMutex: the ring thread keeps going meanwhile.
+        m_handlers.flush();
+        break;
+    }
+    default:
+        reply.status = static_cast<uint32_t>(InputIpc::Status::Invalid);
+        break;
+    }
+    return reply;
+}
+
+bool InputServer::ReadFrom(Connection& connection)
+{
+    size_t used = connection.received.size();
+    connection.received.resize(used + m_receiveChunkSize);
+    ptrdiff_t received = LocalSocket::Receive(connection.socket, connection.received.data() + used, m_receiveChunkSize);
+    connection.received.resize(used + (received > 0 ? static_cast<size_t>(received) : 0));
+    if (received <= 0)
+        return false;
+
+    size_t consumed = 0;
+    while (connection.received.size() - consumed >= sizeof(InputIpc::MessageHeader))
+    {
+        InputIpc::MessageHeader header;
+        std::memcpy(&header, connection.received.data() + consumed, sizeof(header));
+        if (header.magic != InputIpc::m_magic || header.size > InputIpc::m_maxMessagePayloadSizeInBytes)
+        {
+            // Out of step with the client; nothing after this can be trusted.
+            InputIpc::Reply reply{ static_cast<uint32_t>(InputIpc::Status::Invalid), 0 };
+            LocalSocket::SendAll(connection.socket, &reply, sizeof(reply));
+            return false;
+        }
+        if (connection.received.size() - consumed < sizeof(header) + header.size)
+            break;
+
+        InputIpc::Reply reply = HandleMessage(header, connection.received.data() + consumed + sizeof(header));
+        consumed += sizeof(header) + header.size;
+        m_messages.fetch_add(1, std::memory_order_relaxed);
+        if (!LocalSocket::SendAll(connection.socket, &reply, sizeof(reply)))
+            return false;
+    }
+    connection.received.erase(connection.received.begin(), connection.received.begin() + consumed);
+    return true;
+}
+
+void InputServer::SocketLoop()
+{
+    std::vector<LocalSocket::Handle> sockets;
+    std::vector<uint8_t> readable;
+    while (m_running.load(std::memory_order_acquire))
+    {
+        sockets.clear();
+        sockets.push_back(m_listenSocket);
+        for (const auto& connection : m_connections)
+            sockets.push_back(connection.socket);
+        readable.assign(sockets.size(), 0);
+
+        if (!LocalSocket::WaitReadable(sockets.data(), sockets.size(), readable.data(), m_idleWait))
+            continue;
+
+        // Connections first: indices shift once the listener adds one.
+        for (size_t i = m_connections.size(); i-- > 0;)
+        {
+            if (!readable[i + 1] || ReadFrom(m_connections[i]))
+                continue;
+            LocalSocket::Close(m_connections[i].socket);
+            m_connections.erase(m_connections.begin() + static_cast<ptrdiff_t>(i));
+        }
+        if (readable[0])
+        {
+            auto socket = LocalSocket::Accept(m_listenSocket);
+            if (socket != LocalSocket::m_invalid)
+                m_connections.push_back({ socket, {} });
+        }
+        m_clients.store(m_connections.size(), std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,91 @@
+#ifndef INPUT_SERVER_H
+#define INPUT_SERVER_H
+
+#include "BleEmulatorTypes.h"
+#include "InputEvent.h"
+#include "LatencyHistogram.h"
+#include "SharedInputRing.h"
+#include <atomic>
+#include <cstddef>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Daemon front-end for producers in other local processes (see InputIpc.h).
+// One thread drains the shared-memory ring, another serves the control
+// socket; both hand events to the emulator through the handlers.
+class InputServer
+{
+public:
+    struct Handlers
+    {
+        // Called with runs of events in the order producers sent them, on
+        // either server thread but never on both at once.
+        std::function<SubmitStatus(const InputEvent* events, size_t count)> submit;
+        std::function<size_t(const std::string& utf8)> typeText;
+        std::function<void()> flush;
+    };
+
+    explicit InputServer(Handlers handlers);
+    ~InputServer();
+
+    InputServer(const InputServer&) = delete;
+    InputServer& operator=(const InputServer&) = delete;
+
+    // Creates the ring and the control socket under name and starts serving.
+    bool Start(const std::string& name, size_t ringCapacity = InputIpc::m_defaultRingCapacity);
+    void Stop();
+    bool IsRunning() const { return m_running.load(std::memory_order_acquire); }
+
+    InputServerStats GetStats() const;
+    // Restarts the transfer latency window; counters keep running.
+    void ResetStats();
+
+private:
+    struct Connection {
+        intptr_t socket;
+        std::vector<uint8_t> received;
+    };
+
+    void RingLoop();
+    void SocketLoop();
+    // False when the connection must be closed.
+    bool ReadFrom(Connection& connection);
+    InputIpc::Reply HandleMessage(const InputIpc::MessageHeader& header, const uint8_t* payload);
+    // Waits until the ring thread has handed over everything pushed so far.
+    void CatchUpWithRing();
+    // Stamps events in place and hands them on.
+    SubmitStatus Deliver(InputEvent* events, size_t count);
+
+    Handlers m_handlers;
+    SharedInputRing m_ring;
+    std::string m_socketPath;
+    intptr_t m_listenSocket = -1;
+    std::vector<Connection> m_connections;
+
+    std::thread m_ringThread;
+    std::thread m_socketThread;
+    std::atomic<bool> m_running{ false };
+
+    // Serializes the two threads' calls into the handlers.
+    std::mutex m_deliverMutex;
+
+    // The ring thread publishes its dequeue position here for CatchUpWithRing().
+    std::mutex m_progressMutex;
+    std::condition_variable m_progressCondition;
+    uint64_t m_ringHandled = 0;
+
+    std::atomic<uint64_t> m_ringEvents{ 0 };
+    std::atomic<uint64_t> m_socketEvents{ 0 };
+    std::atomic<uint64_t> m_rejectedEvents{ 0 };
+    std::atomic<uint64_t> m_lossyBatches{ 0 };
+    std::atomic<uint64_t> m_messages{ 0 };
+    std::atomic<size_t> m_clients{ 0 };
+    LatencyHistogram m_transferLatency;
+};
+
+#endif // INPUT_SERVER_H
@@ -0,0 +1,83 @@
+#ifndef INPUT_TRACE_H
+#define INPUT_TRACE_H
+
+#include "BleEmulatorTypes.h"
+#include "InputEvent.h"
+#include "PointerTrajectory.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Binary input trace, as written by InputRecorder and read by InputReplayer.
+//
+// The file starts with an 8-byte header ("WBIT", format version, 3 reserved
+// bytes) followed by records appended back to back:
+//
+//   type     1 byte, an InputEventType
+//   delay    varint, microseconds since the previous record
+//   payload  MouseMove: zigzag varints dx, dy, wheel, pan
+//            MousePress/MouseRelease/MouseClick: varint button mask
+//            KeyPress/KeyRelease: varint scan code
+//            AbsoluteMove/TouchDown/Tap: zigzag varints x, y
+//            TypeText: varint character count, then one varint per code point
+//            MouseTrajectory: varint shape, varint duration in microseconds,
+//            varint point count, then zigzag varints x, y per point in
+//            1/256 pixel
+//            others: nothing
+//
+// A typical mouse move takes 6 bytes, a key press 3-4. Version 1 traces,
+// without pan and button masks, still play back as left-button input.
+namespace InputTrace
+{
+    constexpr char m_magic[4] = { 'W', 'B', 'I', 'T' };
+    constexpr uint8_t m_version = 2;
+    constexpr uint8_t m_oldestReadableVersion = 1;
+    constexpr size_t m_headerSizeInBytes = 8;
+    constexpr size_t m_maxVarintSizeInBytes = 10;
+    constexpr double m_pathPointScale = 256.0;
+
+    // One decoded record. text is only set for TypeText, path for MouseTrajectory.
+    struct Record
+    {
+        uint64_t delayMicroseconds;
+        InputEvent event;
+        std::u32string text;
+        PointerPath path;
+    };
+
+    inline size_t EncodeVarint(uint64_t value, uint8_t* out)
+    {
+        size_t size = 0;
+        while (value >= 0x80) {
+            out[size++] = static_cast<uint8_t>(value | 0x80);
+            value >>= 7;
+        }
+        out[size++] = static_cast<uint8_t>(value);
+        return size;
+    }
+
+    // Returns false on a truncated or overlong varint.
+    inline bool DecodeVarint(const uint8_t*& cursor, const uint8_t* end, uint64_t& value)
+    {
+        value = 0;
+        for (unsigned shift = 0; shift < 64 && cursor < end; shift += 7) {
+            uint8_t byte = *cursor++;
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+                return true;
+        }
+        return false;
+    }
+
+    inline uint64_t ZigZag(int64_t value)
+    {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    inline int64_t UnZigZag(uint64_t value)
+    {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+}
+
+#endif // INPUT_TRACE_H
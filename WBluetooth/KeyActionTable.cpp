@@ -0,0 +1,69 @@
+#include "KeyActionTable.h"
+#include <iterator>
+
+void KeyActionTable::SetKey(uint8_t usage)
+{
+    RemoveSequence(usage);
+    m_actions[usage] = {};
+}
+
+void KeyActionTable::SetConsumer(uint8_t usage, uint16_t consumerUsage)
+{
+    RemoveSequence(usage);
+    m_actions[usage] = { KeyActionType::Consumer, consumerUsage, 0, 0 };
+}
+
+void KeyActionTable::SetSequence(uint8_t usage, const KeyboardInputReport* reports, size_t count)
+{
+    RemoveSequence(usage);
+    m_actions[usage] = { KeyActionType::Sequence, 0, static_cast<uint32_t>(m_sequences.size()), static_cast<uint32_t>(count) };
+    m_sequences.insert(m_sequences.end(), reports, reports + count);
+}
+
+void KeyActionTable::SetChord(uint8_t usage, uint8_t modifiers, uint8_t keyUsage)
+{
+    const KeyboardInputReport reports[] = {
+        { modifiers, 0, {} },
+        { modifiers, 0, { keyUsage } },
+        { modifiers, 0, {} },
+    };
+    SetSequence(usage, reports, std::size(reports));
+}
+
+void KeyActionTable::Clear()
+{
+    m_actions.fill({});
+    m_sequences.clear();
+}
+
+void KeyActionTable::RemoveSequence(uint8_t usage)
+{
+    const Action removed = m_actions[usage];
+    if (removed.type != KeyActionType::Sequence)
+        return;
+
+    auto first = m_sequences.begin() + removed.sequenceOffset;
+    m_sequences.erase(first, first + removed.sequenceLength);
+    for (auto& action : m_actions)
+    {
+        if (action.type == KeyActionType::Sequence && action.sequenceOffset > removed.sequenceOffset)
+            action.sequenceOffset -= removed.sequenceLength;
+    }
+    m_actions[usage] = {};
+}
+
+KeyActionTable KeyActionTable::Default()
+{
+    KeyActionTable table;
+    table.SetConsumer(0x3A, 0x0223);                // F1 → Home
+    table.SetChord(0x3B, m_leftControl, 0x2B);      // F2 → Ctrl+Tab
+    table.SetConsumer(0x3C, 0x0224);                // F3 → Back
+    table.SetConsumer(0x3D, 0x0221);                // F4 → Search
+    table.SetConsumer(0x3E, 0x00B6);                // F5 → Previous Track
+    table.SetConsumer(0x3F, 0x00CD);                // F6 → Play/Pause
+    table.SetConsumer(0x40, 0x00B5);                // F7 → Next Track
+    table.SetConsumer(0x41, 0x00E2);                // F8 → Mute
+    table.SetConsumer(0x42, 0x00EA);                // F9 → Volume Down
+    table.SetConsumer(0x43, 0x00E9);                // F10 → Volume Up
+    return table;
+}
@@ -0,0 +1,57 @@
+#ifndef KEY_ACTION_TABLE_H
+#define KEY_ACTION_TABLE_H
+
+#include "HidReports.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+enum class KeyActionType : uint8_t
+{
+    Key,        // the usage itself goes into the keyboard report
+    Consumer,   // a consumer control usage, held as long as the key
+    Sequence    // precompiled keyboard reports, played once on press
+};
+
+// What each keyboard usage does, found by indexing with the usage rather
+// than searching. Tables are plain values: build or edit one, then hand it
+// to KeyboardReportEngine::SetKeyActions() to replace the active one whole.
+class KeyActionTable
+{
+public:
+    static constexpr uint8_t m_leftControl = 0x01;
+
+    struct Action {
+        KeyActionType type;
+        uint16_t consumerUsage;     // Consumer
+        uint32_t sequenceOffset;    // Sequence: first report in the table's sequence storage
+        uint32_t sequenceLength;
+    };
+
+    // Every usage a plain key.
+    KeyActionTable() = default;
+
+    void SetKey(uint8_t usage);
+    void SetConsumer(uint8_t usage, uint16_t consumerUsage);
+    // The engine restores the state of held keys after the last report.
+    void SetSequence(uint8_t usage, const KeyboardInputReport* reports, size_t count);
+    // Taps keyUsage with modifiers held, e.g. Ctrl+Tab.
+    void SetChord(uint8_t usage, uint8_t modifiers, uint8_t keyUsage);
+    void Clear();
+
+    const Action& operator[](uint8_t usage) const { return m_actions[usage]; }
+    const KeyboardInputReport* SequenceReports(const Action& action) const { return m_sequences.data() + action.sequenceOffset; }
+
+    // F1-F10 as on the K580 keyboard: media and browser keys, F2 as Ctrl+Tab.
+    static KeyActionTable Default();
+
+private:
+    // Drops the reports of a Sequence action so rebinding does not pile them up.
+    void RemoveSequence(uint8_t usage);
+
+    std::array<Action, 256> m_actions{};
+    std::vector<KeyboardInputReport> m_sequences;
+};
+
+#endif // KEY_ACTION_TABLE_H
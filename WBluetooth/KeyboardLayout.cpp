@@ -0,0 +1,100 @@
+#include "KeyboardLayout.h"
+
+void KeyboardLayout::Map(char32_t character, uint8_t usage, uint8_t modifiers)
+{
+    if (character < m_ascii.size())
+        m_ascii[character] = { usage, modifiers };
+    else
+        m_extended[character] = { usage, modifiers };
+}
+
+const KeyboardLayout::KeyStroke* KeyboardLayout::Find(char32_t character) const
+{
+    if (character < m_ascii.size())
+        return m_ascii[character].usage != 0 ? &m_ascii[character] : nullptr;
+
+    auto it = m_extended.find(character);
+    return it != m_extended.end() ? &it->second : nullptr;
+}
+
+// Keys that sit at the same place with the same meaning on both layouts.
+static void MapCommonKeys(KeyboardLayout& layout)
+{
+    for (char32_t c = U'a'; c <= U'z'; ++c)
+    {
+        layout.Map(c, static_cast<uint8_t>(0x04 + (c - U'a')));
+        layout.Map(c - U'a' + U'A', static_cast<uint8_t>(0x04 + (c - U'a')), KeyboardLayout::m_leftShift);
+    }
+
+    for (char32_t c = U'1'; c <= U'9'; ++c)
+        layout.Map(c, static_cast<uint8_t>(0x1E + (c - U'1')));
+    layout.Map(U'0', 0x27);
+
+    layout.Map(U'\n', 0x28); // Enter
+    layout.Map(U'\t', 0x2B); // Tab
+    layout.Map(U' ', 0x2C);  // Space
+    layout.Map(U',', 0x36);
+    layout.Map(U'.', 0x37);
+}
+
+KeyboardLayout KeyboardLayout::UnitedStates()
+{
+    KeyboardLayout layout;
+    MapCommonKeys(layout);
+
+    const char32_t shiftedDigits[] = U")!@#$%^&*(";
+    for (int i = 0; i < 10; ++i)
+        layout.Map(shiftedDigits[i], static_cast<uint8_t>(i == 0 ? 0x27 : 0x1E + (i - 1)), m_leftShift);
+
+    layout.Map(U'-', 0x2D);  layout.Map(U'_', 0x2D, m_leftShift);
+    layout.Map(U'=', 0x2E);  layout.Map(U'+', 0x2E, m_leftShift);
+    layout.Map(U'[', 0x2F);  layout.Map(U'{', 0x2F, m_leftShift);
+    layout.Map(U']', 0x30);  layout.Map(U'}', 0x30, m_leftShift);
+    layout.Map(U'\\', 0x31); layout.Map(U'|', 0x31, m_leftShift);
+    layout.Map(U';', 0x33);  layout.Map(U':', 0x33, m_leftShift);
+    layout.Map(U'\'', 0x34); layout.Map(U'"', 0x34, m_leftShift);
+    layout.Map(U'`', 0x35);  layout.Map(U'~', 0x35, m_leftShift);
+    layout.Map(U'<', 0x36, m_leftShift);
+    layout.Map(U'>', 0x37, m_leftShift);
+    layout.Map(U'/', 0x38);  layout.Map(U'?', 0x38, m_leftShift);
+    return layout;
+}
+
+// German T1 (QWERTZ). Dead keys (^, ´, `) are left unmapped: they need a
+// second keystroke to produce a character.
+KeyboardLayout KeyboardLayout::German()
+{
+    KeyboardLayout layout;
+    MapCommonKeys(layout);
+
+    layout.Map(U'y', 0x1D); layout.Map(U'Y', 0x1D, m_leftShift);
+    layout.Map(U'z', 0x1C); layout.Map(U'Z', 0x1C, m_leftShift);
+
+    const char32_t shiftedDigits[] = U"=!\"\u00A7$%&/()";  // §
+    for (int i = 0; i < 10; ++i)
+        layout.Map(shiftedDigits[i], static_cast<uint8_t>(i == 0 ? 0x27 : 0x1E + (i - 1)), m_leftShift);
+
+    layout.Map(U'\u00B2', 0x1F, m_rightAlt);  // ²
+    layout.Map(U'\u00B3', 0x20, m_rightAlt);  // ³
+    layout.Map(U'{', 0x24, m_rightAlt);
+    layout.Map(U'[', 0x25, m_rightAlt);
+    layout.Map(U']', 0x26, m_rightAlt);
+    layout.Map(U'}', 0x27, m_rightAlt);
+
+    layout.Map(U'\u00DF', 0x2D);  layout.Map(U'?', 0x2D, m_leftShift); layout.Map(U'\\', 0x2D, m_rightAlt);  // ß
+    layout.Map(U'\u00FC', 0x2F);  layout.Map(U'\u00DC', 0x2F, m_leftShift);  // ü Ü
+    layout.Map(U'+', 0x30);  layout.Map(U'*', 0x30, m_leftShift); layout.Map(U'~', 0x30, m_rightAlt);
+    layout.Map(U'#', 0x32);  layout.Map(U'\'', 0x32, m_leftShift);
+    layout.Map(U'\u00F6', 0x33);  layout.Map(U'\u00D6', 0x33, m_leftShift);  // ö Ö
+    layout.Map(U'\u00E4', 0x34);  layout.Map(U'\u00C4', 0x34, m_leftShift);  // ä Ä
+    layout.Map(U'\u00B0', 0x35, m_leftShift);  // °
+    layout.Map(U';', 0x36, m_leftShift);
+    layout.Map(U':', 0x37, m_leftShift);
+    layout.Map(U'-', 0x38);  layout.Map(U'_', 0x38, m_leftShift);
+    layout.Map(U'<', 0x64);  layout.Map(U'>', 0x64, m_leftShift); layout.Map(U'|', 0x64, m_rightAlt);
+
+    layout.Map(U'@', 0x14, m_rightAlt);      // @ on Q
+    layout.Map(U'\u20AC', 0x08, m_rightAlt); // € on E
+    layout.Map(U'\u00B5', 0x10, m_rightAlt); // µ on M
+    return layout;
+}
@@ -0,0 +1,35 @@
+#ifndef KEYBOARD_LAYOUT_H
+#define KEYBOARD_LAYOUT_H
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+
+// Which key (HID usage) and modifier bits produce a character on the host's
+// keyboard layout. Layouts are plain tables, so callers can build their own.
+class KeyboardLayout
+{
+public:
+    static constexpr uint8_t m_leftShift = 0x02;
+    static constexpr uint8_t m_rightAlt = 0x40; // AltGr on ISO layouts
+
+    struct KeyStroke {
+        uint8_t usage;
+        uint8_t modifiers;
+    };
+
+    KeyboardLayout() = default;
+
+    void Map(char32_t character, uint8_t usage, uint8_t modifiers = 0);
+    const KeyStroke* Find(char32_t character) const;
+
+    static KeyboardLayout UnitedStates();
+    static KeyboardLayout German();
+
+private:
+    // Direct-indexed for ASCII, hashed for everything else.
+    std::array<KeyStroke, 128> m_ascii{};
+    std::unordered_map<char32_t, KeyStroke> m_extended;
+};
+
+#endif // KEYBOARD_LAYOUT_H
@@ -0,0 +1,162 @@
+#include "KeyboardReportEngine.h"
+#include "HidHelper.h"
+
+KeyboardReportEngine::KeyboardReportEngine(HidReportSink& sink, KeyActionTable actions)
+    : m_sink(sink)
+    , m_activeActions(std::make_unique<const KeyActionTable>(actions))
+    , m_actions(std::move(actions))
+{
+}
+
+KeyboardReportEngine::~KeyboardReportEngine()
+{
+    delete m_pendingActions.load(std::memory_order_acquire);
+}
+
+void KeyboardReportEngine::PressKey(uint32_t scanCode)
+{
+    uint8_t usage = HidHelper::GetHidUsageFromPs2Set1(scanCode);
+    const KeyActionTable& actions = ActiveActions();
+    const KeyActionTable::Action& action = actions[usage];
+    m_pressedActions[usage] = action;
+
+    switch (action.type)
+    {
+    case KeyActionType::Key:
+        ChangeKeyState(true, usage);
+        break;
+    case KeyActionType::Consumer:
+        SendConsumerControlKey(true, action.consumerUsage);
+        break;
+    case KeyActionType::Sequence:
+        SendReportSequence(actions.SequenceReports(action), action.sequenceLength, m_keyState.Modifiers());
+        break;
+    }
+}
+
+void KeyboardReportEngine::ReleaseKey(uint32_t scanCode)
+{
+    uint8_t usage = HidHelper::GetHidUsageFromPs2Set1(scanCode);
+    const KeyActionTable::Action& action = m_pressedActions[usage];
+
+    switch (action.type)
+    {
+    case KeyActionType::Key:
+        ChangeKeyState(false, usage);
+        break;
+    case KeyActionType::Consumer:
+        SendConsumerControlKey(false, action.consumerUsage);
+        break;
+    case KeyActionType::Sequence:
+        // Played in full on press.
+        break;
+    }
+    m_pressedActions[usage] = {};
+}
+
+void KeyboardReportEngine::DirectSendReport(const std::vector<uint8_t>& reportValue)
+{
+    if (reportValue.size() == m_sizeOfKeyboardReportDataInBytes)
+        m_sink.SendReport(HidReportId::Keyboard, reportValue.data(), reportValue.size());
+}
+
+void KeyboardReportEngine::SendReportSequence(const KeyboardInputReport* reports, size_t count, uint8_t heldModifiers)
+{
+    if (count == 0 || !m_sink.IsReady(HidReportId::Keyboard))
+        return;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        KeyboardInputReport report = reports[i];
+        report.modifiers |= heldModifiers;
+        m_sink.SendReport(HidReportId::Keyboard, reinterpret_cast<const uint8_t*>(&report), sizeof(report));
+    }
+
+    KeyboardState::Report report;
+    m_keyState.BuildReport(report);
+    m_sink.SendReport(HidReportId::Keyboard, reinterpret_cast<const uint8_t*>(&report), sizeof(report));
+}
+
+void KeyboardReportEngine::SetKeyActions(const KeyActionTable& actions)
+{
+    std::scoped_lock lock(m_actionsMutex);
+    m_actions = actions;
+    PublishActions();
+}
+
+KeyActionTable KeyboardReportEngine::GetKeyActions() const
+{
+    std::scoped_lock lock(m_actionsMutex);
+    return m_actions;
+}
+
+void KeyboardReportEngine::SetFunctionKeyBinding(FunctionKey key, uint16_t consumerUsage)
+{
+    std::scoped_lock lock(m_actionsMutex);
+    m_actions.SetConsumer(static_cast<uint8_t>(key), consumerUsage);
+    PublishActions();
+}
+
+void KeyboardReportEngine::ClearFunctionKeyBinding(FunctionKey key)
+{
+    std::scoped_lock lock(m_actionsMutex);
+    m_actions.SetKey(static_cast<uint8_t>(key));
+    PublishActions();
+}
+
+void KeyboardReportEngine::ClearAllFunctionKeyBindings()
+{
+    std::scoped_lock lock(m_actionsMutex);
+    for (auto key = static_cast<uint8_t>(FunctionKey::F1); key <= static_cast<uint8_t>(FunctionKey::F12); ++key)
+        m_actions.SetKey(key);
+    PublishActions();
+}
+
+void KeyboardReportEngine::PublishActions()
+{
+    auto* table = new KeyActionTable(m_actions);
+    delete m_pendingActions.exchange(table, std::memory_order_acq_rel);
+}
+
+const KeyActionTable& KeyboardReportEngine::ActiveActions()
+{
+    // One relaxed load per key while nothing changes.
+    if (m_pendingActions.load(std::memory_order_relaxed) != nullptr)
+    {
+        if (const KeyActionTable* table = m_pendingActions.exchange(nullptr, std::memory_order_acquire))
+            m_activeActions.reset(table);
+    }
+    return *m_activeActions;
+}
+
+void KeyboardReportEngine::ChangeKeyState(bool isPress, uint8_t usage)
+{
+    if (!m_sink.IsReady(HidReportId::Keyboard))
+        return;
+
+    if (isPress)
+        m_keyState.Press(usage);
+    else
+        m_keyState.Release(usage);
+
+    KeyboardState::Report report;
+    m_keyState.BuildReport(report);
+
+    m_sink.SendReport(HidReportId::Keyboard, reinterpret_cast<const uint8_t*>(&report), sizeof(report));
+}
+
+void KeyboardReportEngine::SendConsumerControlKey(bool isPress, uint16_t usage)
+{
+    if (!m_sink.IsReady(HidReportId::ConsumerControl))
+        return;
+
+    ConsumerControlReport report{ 0x00, 0x00 };
+
+    if (isPress)
+    {
+        report.usageLow = static_cast<uint8_t>(usage & 0xFF);         // LSB
+        report.usageHigh = static_cast<uint8_t>((usage >> 8) & 0xFF); // MSB
+    }
+
+    m_sink.SendReport(HidReportId::ConsumerControl, reinterpret_cast<const uint8_t*>(&report), sizeof(report));
+}
@@ -0,0 +1,92 @@
+#ifndef KEYBOARD_REPORT_ENGINE_H
+#define KEYBOARD_REPORT_ENGINE_H
+
+#include "HidReportSink.h"
+#include "HidReportMaps.h"
+#include "KeyActionTable.h"
+#include "KeyboardState.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Keyboard and consumer control report generation, independent of the transport.
+class KeyboardReportEngine
+{
+public:
+    enum class FunctionKey : uint8_t {
+        F1 = 0x3A,
+        F2 = 0x3B,
+        F3 = 0x3C,
+        F4 = 0x3D,
+        F5 = 0x3E,
+        F6 = 0x3F,
+        F7 = 0x40,
+        F8 = 0x41,
+        F9 = 0x42,
+        F10 = 0x43,
+        F11 = 0x44, // not use
+        F12 = 0x45  // not use
+    };
+
+    static constexpr uint32_t m_sizeOfKeyboardReportDataInBytes =
+        HidDescriptor::InputReportBits(HidReportMaps::Keyboard, HidReportMaps::KeyboardReportId) / 8;
+    static constexpr uint32_t m_sizeOfConsumerReportDataInBytes =
+        HidDescriptor::InputReportBits(HidReportMaps::Keyboard, HidReportMaps::ConsumerReportId) / 8;
+
+    explicit KeyboardReportEngine(HidReportSink& sink, KeyActionTable actions = KeyActionTable::Default());
+    ~KeyboardReportEngine();
+
+    KeyboardReportEngine(const KeyboardReportEngine&) = delete;
+    KeyboardReportEngine& operator=(const KeyboardReportEngine&) = delete;
+
+    void PressKey(uint32_t ps2Set1ScanCode);
+    void ReleaseKey(uint32_t ps2Set1ScanCode);
+    void DirectSendReport(const std::vector<uint8_t>& reportValue);
+
+    // Streams precompiled reports back to back, then restores the reported
+    // state of keys that are held through PressKey. heldModifiers are added
+    // to every report, so a chord keeps e.g. a Shift the user is holding.
+    void SendReportSequence(const KeyboardInputReport* reports, size_t count, uint8_t heldModifiers = 0);
+
+    // Replaces the key action table. May be called from any thread while
+    // another one presses keys: the new table is picked up on the next
+    // PressKey without a lock, and keys held across the swap are released
+    // the way they were pressed.
+    void SetKeyActions(const KeyActionTable& actions);
+    KeyActionTable GetKeyActions() const;
+
+    // for function keys, edits of the current table
+    void SetFunctionKeyBinding(FunctionKey key, uint16_t consumerUsage);
+    void ClearFunctionKeyBinding(FunctionKey key);
+    // Makes F1-F12 plain keys again; other usages keep their actions.
+    void ClearAllFunctionKeyBindings();
+
+private:
+    void ChangeKeyState(bool isPress, uint8_t hidUsage);
+    void SendConsumerControlKey(bool isPress, uint16_t usage);
+    // Hands a copy of m_actions over to the pressing thread; caller holds m_actionsMutex.
+    void PublishActions();
+    const KeyActionTable& ActiveActions();
+
+    HidReportSink& m_sink;
+
+    // State Variables
+    KeyboardState m_keyState;
+    // What each held key did when pressed, so its release matches.
+    std::array<KeyActionTable::Action, 256> m_pressedActions{};
+
+    // The table in use, owned by the pressing thread, and at most one newer
+    // table waiting for it; a writer takes back and deletes a table the
+    // pressing thread never picked up.
+    std::unique_ptr<const KeyActionTable> m_activeActions;
+    std::atomic<const KeyActionTable*> m_pendingActions{ nullptr };
+
+    // Writer side: the latest table set, for edits and GetKeyActions().
+    mutable std::mutex m_actionsMutex;
+    KeyActionTable m_actions;
+};
+
+#endif // KEYBOARD_REPORT_ENGINE_H
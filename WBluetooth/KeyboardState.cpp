@@ -0,0 +1,96 @@
+#include "KeyboardState.h"
+#include "HidHelper.h"
+#include <algorithm>
+
+bool KeyboardState::IsPressed(uint8_t usage) const
+{
+    return (m_bitmap[usage >> 6] >> (usage & 63)) & 1;
+}
+
+bool KeyboardState::Press(uint8_t usage)
+{
+    // 0x00 is "no event"; it is what an unknown scan code translates to.
+    if (usage == 0 || IsPressed(usage))
+        return false;
+
+    SetBit(usage);
+
+    if (HidHelper::IsModifierKey(usage))
+    {
+        m_modifiers |= HidHelper::GetFlagOfModifierKey(usage);
+        return true;
+    }
+
+    if (m_slotCount < m_maxKeysPerReport)
+    {
+        auto freeSlot = std::find(m_slots.begin(), m_slots.end(), uint8_t{ 0 });
+        *freeSlot = usage;
+        ++m_slotCount;
+    }
+    else
+    {
+        m_overflow[m_overflowCount++] = usage;
+    }
+    return true;
+}
+
+bool KeyboardState::Release(uint8_t usage)
+{
+    if (usage == 0 || !IsPressed(usage))
+        return false;
+
+    ClearBit(usage);
+
+    if (HidHelper::IsModifierKey(usage))
+    {
+        m_modifiers &= ~HidHelper::GetFlagOfModifierKey(usage);
+        return true;
+    }
+
+    auto slot = std::find(m_slots.begin(), m_slots.end(), usage);
+    if (slot != m_slots.end())
+    {
+        // The oldest waiting key inherits the slot; everyone else stays put.
+        if (m_overflowCount > 0)
+        {
+            *slot = m_overflow[0];
+            std::copy(m_overflow.begin() + 1, m_overflow.begin() + m_overflowCount, m_overflow.begin());
+            --m_overflowCount;
+        }
+        else
+        {
+            *slot = 0;
+            --m_slotCount;
+        }
+        return true;
+    }
+
+    auto end = m_overflow.begin() + m_overflowCount;
+    auto waiting = std::find(m_overflow.begin(), end, usage);
+    if (waiting != end)
+    {
+        std::copy(waiting + 1, end, waiting);
+        --m_overflowCount;
+    }
+    return true;
+}
+
+void KeyboardState::BuildReport(Report& report) const
+{
+    report.modifiers = m_modifiers;
+    report.reserved = 0;
+
+    if (m_overflowCount > 0)
+        std::fill(std::begin(report.keys), std::end(report.keys), m_errorRollOverUsage);
+    else
+        std::copy(m_slots.begin(), m_slots.end(), std::begin(report.keys));
+}
+
+void KeyboardState::Clear()
+{
+    m_bitmap.fill(0);
+    m_modifiers = 0;
+    m_slots.fill(0);
+    m_slotCount = 0;
+    m_overflowCount = 0;
+}
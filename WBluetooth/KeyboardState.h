@@ -0,0 +1,54 @@
+#ifndef KEYBOARD_STATE_H
+#define KEYBOARD_STATE_H
+
+#include "HidReports.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Pressed-key state of the virtual keyboard, kept in fixed storage so that
+// updating it and building a report never allocates or hashes.
+//
+// Non-modifier keys occupy one of six report slots and keep that slot until
+// they are released. Keys pressed while all slots are taken wait in press
+// order for a slot to free up; as long as any key is waiting, the report
+// carries ErrorRollOver in every slot, as the HID spec asks for.
+class KeyboardState
+{
+public:
+    static constexpr size_t m_sizeOfReportInBytes = sizeof(KeyboardInputReport);
+    static constexpr size_t m_maxKeysPerReport = 6;
+    static constexpr uint8_t m_errorRollOverUsage = 0x01;
+
+    using Report = KeyboardInputReport;
+
+    KeyboardState() = default;
+
+    // Return true when the key state actually changed.
+    bool Press(uint8_t usage);
+    bool Release(uint8_t usage);
+
+    bool IsPressed(uint8_t usage) const;
+    uint8_t Modifiers() const { return m_modifiers; }
+    size_t PressedKeyCount() const { return m_slotCount + m_overflowCount; }
+    bool IsRolledOver() const { return m_overflowCount > 0; }
+
+    void BuildReport(Report& report) const;
+    void Clear();
+
+private:
+    void SetBit(uint8_t usage) { m_bitmap[usage >> 6] |= (uint64_t{ 1 } << (usage & 63)); }
+    void ClearBit(uint8_t usage) { m_bitmap[usage >> 6] &= ~(uint64_t{ 1 } << (usage & 63)); }
+
+    std::array<uint64_t, 4> m_bitmap{};
+    uint8_t m_modifiers = 0;
+
+    std::array<uint8_t, m_maxKeysPerReport> m_slots{};
+    size_t m_slotCount = 0;
+
+    // Keys beyond the six slots, oldest first.
+    std::array<uint8_t, 256> m_overflow{};
+    size_t m_overflowCount = 0;
+};
+
+#endif // KEYBOARD_STATE_H
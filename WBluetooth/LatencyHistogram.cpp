@@ -0,0 +1,86 @@
+#include "LatencyHistogram.h"
+#include <algorithm>
+
+size_t LatencyHistogram::BucketOf(uint64_t value)
+{
+    value = std::min(value, (uint64_t(1) << m_maxValueBits) - 1);
+    if (value < 2 * m_subBucketCount)
+        return static_cast<size_t>(value);
+
+    int topBit = 63;
+    while ((value >> topBit) == 0)
+        --topBit;
+    int shift = topBit - m_subBucketBits;
+    return static_cast<size_t>(shift) * m_subBucketCount + static_cast<size_t>(value >> shift);
+}
+
+uint64_t LatencyHistogram::UpperBoundOf(size_t bucket)
+{
+    if (bucket < 2 * m_subBucketCount)
+        return bucket;
+
+    size_t shift = bucket / m_subBucketCount - 1;
+    uint64_t mantissa = bucket - shift * m_subBucketCount;
+    return ((mantissa + 1) << shift) - 1;
+}
+
+void LatencyHistogram::Record(std::chrono::nanoseconds duration)
+{
+    uint64_t value = duration.count() > 0 ? static_cast<uint64_t>(duration.count()) : 0;
+    m_buckets[BucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(value, std::memory_order_relaxed);
+
+    uint64_t max = m_max.load(std::memory_order_relaxed);
+    while (value > max && !m_max.compare_exchange_weak(max, value, std::memory_order_relaxed))
+    {
+    }
+}
+
+LatencySummary LatencyHistogram::Summarize() const
+{
+    // Buckets are read one by one while writers carry on; the total is taken
+    // from the buckets themselves so percentiles stay consistent with them.
+    std::array<uint64_t, m_bucketCount> counts;
+    uint64_t total = 0;
+    for (size_t i = 0; i < m_bucketCount; ++i)
+    {
+        counts[i] = m_buckets[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+
+    LatencySummary summary{};
+    summary.count = total;
+    if (total == 0)
+        return summary;
+
+    uint64_t max = m_max.load(std::memory_order_relaxed);
+    summary.mean = std::chrono::nanoseconds(m_sum.load(std::memory_order_relaxed) / std::max<uint64_t>(m_count.load(std::memory_order_relaxed), 1));
+    summary.max = std::chrono::nanoseconds(max);
+
+    auto percentile = [&](double fraction) {
+        uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(fraction * static_cast<double>(total) + 0.5));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < m_bucketCount; ++i)
+        {
+            seen += counts[i];
+            if (seen >= rank)
+                return std::chrono::nanoseconds(std::min(UpperBoundOf(i), max));
+        }
+        return std::chrono::nanoseconds(max);
+    };
+    summary.p50 = percentile(0.50);
+    summary.p90 = percentile(0.90);
+    summary.p99 = percentile(0.99);
+    summary.p999 = percentile(0.999);
+    return summary;
+}
+
+void LatencyHistogram::Reset()
+{
+    for (auto& bucket : m_buckets)
+        bucket.store(0, std::memory_order_relaxed);
+    m_count.store(0, std::memory_order_relaxed);
+    m_sum.store(0, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,43 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include "BleEmulatorTypes.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// Log-linear histogram of durations, in the style of HdrHistogram: every
+// power of two is split into m_subBucketCount linear buckets, so any recorded
+// value is off by at most 1/32 of itself. Record() is a handful of relaxed
+// atomic adds, safe from any number of threads; Summarize() may run alongside.
+class LatencyHistogram
+{
+public:
+    static constexpr int m_subBucketBits = 5;
+    static constexpr uint64_t m_subBucketCount = uint64_t(1) << m_subBucketBits;
+    // Longer durations (about 18 minutes) are counted in the last bucket.
+    static constexpr int m_maxValueBits = 40;
+    static constexpr size_t m_bucketCount = (m_maxValueBits - m_subBucketBits + 1) * m_subBucketCount;
+
+    LatencyHistogram() = default;
+
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    void Record(std::chrono::nanoseconds duration);
+    LatencySummary Summarize() const;
+    void Reset();
+
+private:
+    static size_t BucketOf(uint64_t value);
+    // Highest value that falls into the bucket.
+    static uint64_t UpperBoundOf(size_t bucket);
+
+    std::array<std::atomic<uint64_t>, m_bucketCount> m_buckets{};
+    std::atomic<uint64_t> m_count{ 0 };
+    std::atomic<uint64_t> m_sum{ 0 };
+    std::atomic<uint64_t> m_max{ 0 };
+};
+
+#endif // LATENCY_HISTOGRAM_H
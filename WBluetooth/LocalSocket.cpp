@@ -0,0 +1,197 @@
+#include "LocalSocket.h"
+#include <cstring>
+#include <vector>
+
+#if defined(_WIN32)
+#include <winsock2.h>
+#include <afunix.h>
+#include <mutex>
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+#if defined(_WIN32)
+    using NativeSocket = SOCKET;
+
+    void StartSockets()
+    {
+        static std::once_flag started;
+        std::call_once(started, [] {
+            WSADATA data{};
+            WSAStartup(MAKEWORD(2, 2), &data);
+        });
+    }
+#else
+    using NativeSocket = int;
+
+    void StartSockets()
+    {
+    }
+#endif
+
+    NativeSocket Native(LocalSocket::Handle socket)
+    {
+        return static_cast<NativeSocket>(socket);
+    }
+
+    bool MakeAddress(const std::string& path, sockaddr_un& address)
+    {
+        std::memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(address.sun_path))
+            return false;
+        std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+        return true;
+    }
+
+    LocalSocket::Handle OpenStream()
+    {
+        StartSockets();
+        NativeSocket native = socket(AF_UNIX, SOCK_STREAM, 0);
+#if defined(_WIN32)
+        if (native == INVALID_SOCKET)
+            return LocalSocket::m_invalid;
+#else
+        if (native < 0)
+            return LocalSocket::m_invalid;
+#endif
+        return static_cast<LocalSocket::Handle>(native);
+    }
+}
+
+LocalSocket::Handle LocalSocket::Listen(const std::string& path)
+{
+    sockaddr_un address;
+    if (!MakeAddress(path, address))
+        return m_invalid;
+
+    Handle listener = OpenStream();
+    if (listener == m_invalid)
+        return m_invalid;
+
+    Unlink(path);
+    if (bind(Native(listener), reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(Native(listener), SOMAXCONN) != 0) {
+        Close(listener);
+        return m_invalid;
+    }
+    return listener;
+}
+
+LocalSocket::Handle LocalSocket::Accept(Handle listener)
+{
+    auto native = accept(Native(listener), nullptr, nullptr);
+#if defined(_WIN32)
+    return native == INVALID_SOCKET ? m_invalid : static_cast<Handle>(native);
+#else
+    return native < 0 ? m_invalid : static_cast<Handle>(native);
+#endif
+}
+
+LocalSocket::Handle LocalSocket::Connect(const std::string& path)
+{
+    sockaddr_un address;
+    if (!MakeAddress(path, address))
+        return m_invalid;
+
+    Handle socket = OpenStream();
+    if (socket == m_invalid)
+        return m_invalid;
+    if (connect(Native(socket), reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        Close(socket);
+        return m_invalid;
+    }
+    return socket;
+}
+
+void LocalSocket::Close(Handle socket)
+{
+    if (socket == m_invalid)
+        return;
+#if defined(_WIN32)
+    closesocket(Native(socket));
+#else
+    close(Native(socket));
+#endif
+}
+
+void LocalSocket::Unlink(const std::string& path)
+{
+#if defined(_WIN32)
+    DeleteFileA(path.c_str());
+#else
+    unlink(path.c_str());
+#endif
+}
+
+bool LocalSocket::SendAll(Handle socket, const void* data, size_t size)
+{
+    auto bytes = static_cast<const char*>(data);
+    while (size > 0)
+    {
+#if defined(_WIN32)
+        int sent = send(Native(socket), bytes, static_cast<int>(size), 0);
+#else
+        // A vanished peer must not take the process down with SIGPIPE.
+        ssize_t sent = send(Native(socket), bytes, size, MSG_NOSIGNAL);
+#endif
+        if (sent <= 0)
+            return false;
+        bytes += sent;
+        size -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+bool LocalSocket::ReceiveAll(Handle socket, void* data, size_t size)
+{
+    auto bytes = static_cast<uint8_t*>(data);
+    while (size > 0)
+    {
+        ptrdiff_t received = Receive(socket, bytes, size);
+        if (received <= 0)
+            return false;
+        bytes += received;
+        size -= static_cast<size_t>(received);
+    }
+    return true;
+}
+
+ptrdiff_t LocalSocket::Receive(Handle socket, void* data, size_t size)
+{
+#if defined(_WIN32)
+    return recv(Native(socket), static_cast<char*>(data), static_cast<int>(size), 0);
+#else
+    return recv(Native(socket), data, size, 0);
+#endif
+}
+
+bool LocalSocket::WaitReadable(const Handle* sockets, size_t count, uint8_t* readable, std::chrono::milliseconds timeout)
+{
+#if defined(_WIN32)
+    std::vector<WSAPOLLFD> polled(count);
+#else
+    std::vector<pollfd> polled(count);
+#endif
+    for (size_t i = 0; i < count; ++i)
+    {
+        polled[i].fd = Native(sockets[i]);
+        polled[i].events = POLLIN;
+        polled[i].revents = 0;
+    }
+
+#if defined(_WIN32)
+    int ready = WSAPoll(polled.data(), static_cast<ULONG>(count), static_cast<INT>(timeout.count()));
+#else
+    int ready = poll(polled.data(), static_cast<nfds_t>(count), static_cast<int>(timeout.count()));
+#endif
+    for (size_t i = 0; i < count; ++i)
+        readable[i] = ready > 0 && (polled[i].revents & (POLLIN | POLLHUP | POLLERR)) != 0;
+    return ready > 0;
+}
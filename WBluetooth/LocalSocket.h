@@ -0,0 +1,35 @@
+#ifndef LOCAL_SOCKET_H
+#define LOCAL_SOCKET_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Thin blocking wrapper over Unix domain stream sockets, which Windows 10
+// also offers through Winsock. Handles are plain integers so headers do not
+// need the platform socket types.
+namespace LocalSocket
+{
+    using Handle = intptr_t;
+    constexpr Handle m_invalid = -1;
+
+    // Binds path, replacing a socket file left behind by a previous run.
+    Handle Listen(const std::string& path);
+    Handle Accept(Handle listener);
+    Handle Connect(const std::string& path);
+    void Close(Handle socket);
+    // Removes the socket file of a listener.
+    void Unlink(const std::string& path);
+
+    bool SendAll(Handle socket, const void* data, size_t size);
+    bool ReceiveAll(Handle socket, void* data, size_t size);
+    // Bytes read; 0 once the peer has closed, negative on error.
+    ptrdiff_t Receive(Handle socket, void* data, size_t size);
+
+    // Waits until any of the sockets is readable (or has been closed by the
+    // peer) or timeout has passed; readable[i] tells which are.
+    bool WaitReadable(const Handle* sockets, size_t count, uint8_t* readable, std::chrono::milliseconds timeout);
+}
+
+#endif // LOCAL_SOCKET_H
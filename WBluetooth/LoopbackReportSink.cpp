@@ -0,0 +1,69 @@
+#include "LoopbackReportSink.h"
+#include <algorithm>
+
+bool LoopbackReportSink::IsReady(HidReportId) const
+{
+    return m_connected.load(std::memory_order_relaxed);
+}
+
+void LoopbackReportSink::SendReport(HidReportId reportId, const uint8_t* data, size_t size)
+{
+    if (!m_connected.load(std::memory_order_relaxed))
+        return;
+
+    auto index = static_cast<size_t>(reportId) % m_reportIdCount;
+
+    std::shared_ptr<const ReportHandler> handler;
+    {
+        std::scoped_lock lock(m_mutex);
+        auto& slot = m_lastReports[index];
+        slot.size = std::min(size, slot.data.size());
+        std::copy(data, data + slot.size, slot.data.begin());
+        handler = m_reportHandler;
+    }
+
+    m_reportCounts[index].fetch_add(1, std::memory_order_relaxed);
+
+    if (handler)
+        (*handler)(reportId, data, size);
+}
+
+void LoopbackReportSink::SetConnected(bool connected)
+{
+    m_connected.store(connected, std::memory_order_relaxed);
+}
+
+void LoopbackReportSink::SetReportHandler(ReportHandler handler)
+{
+    std::scoped_lock lock(m_mutex);
+    m_reportHandler = handler ? std::make_shared<const ReportHandler>(std::move(handler)) : nullptr;
+}
+
+uint64_t LoopbackReportSink::GetReportCount(HidReportId reportId) const
+{
+    return m_reportCounts[static_cast<size_t>(reportId) % m_reportIdCount].load(std::memory_order_relaxed);
+}
+
+uint64_t LoopbackReportSink::GetTotalReportCount() const
+{
+    uint64_t total = 0;
+    for (const auto& count : m_reportCounts)
+        total += count.load(std::memory_order_relaxed);
+    return total;
+}
+
+std::vector<uint8_t> LoopbackReportSink::GetLastReport(HidReportId reportId) const
+{
+    std::scoped_lock lock(m_mutex);
+    const auto& slot = m_lastReports[static_cast<size_t>(reportId) % m_reportIdCount];
+    return std::vector<uint8_t>(slot.data.begin(), slot.data.begin() + slot.size);
+}
+
+void LoopbackReportSink::Reset()
+{
+    std::scoped_lock lock(m_mutex);
+    for (auto& slot : m_lastReports)
+        slot = ReportSlot{};
+    for (auto& count : m_reportCounts)
+        count.store(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,50 @@
+#ifndef LOOPBACK_REPORT_SINK_H
+#define LOOPBACK_REPORT_SINK_H
+
+#include "HidReportSink.h"
+#include "HidReports.h"
+#include <array>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// In-process sink: keeps the last report per report ID and counts deliveries.
+// Used to build, profile and load-test the input engines without a BLE stack.
+class LoopbackReportSink : public HidReportSink
+{
+public:
+    using ReportHandler = std::function<void(HidReportId, const uint8_t*, size_t)>;
+
+    LoopbackReportSink() = default;
+
+    bool IsReady(HidReportId reportId) const override;
+    void SendReport(HidReportId reportId, const uint8_t* data, size_t size) override;
+
+    // Simulates a central (un)subscribing; reports are not delivered while disconnected.
+    void SetConnected(bool connected);
+    void SetReportHandler(ReportHandler handler);
+
+    uint64_t GetReportCount(HidReportId reportId) const;
+    uint64_t GetTotalReportCount() const;
+    std::vector<uint8_t> GetLastReport(HidReportId reportId) const;
+    void Reset();
+
+private:
+    static constexpr size_t m_reportIdCount = HidReportIdCount;
+    struct ReportSlot {
+        std::array<uint8_t, MaxHidReportSizeInBytes> data{};
+        size_t size = 0;
+    };
+
+    std::atomic<bool> m_connected{ true };
+    std::array<std::atomic<uint64_t>, m_reportIdCount> m_reportCounts{};
+
+    mutable std::mutex m_mutex;
+    std::array<ReportSlot, m_reportIdCount> m_lastReports{};
+    // Shared so SendReport can take a reference without copying the callable.
+    std::shared_ptr<const ReportHandler> m_reportHandler;
+};
+
+#endif // LOOPBACK_REPORT_SINK_H
@@ -0,0 +1,56 @@
+#include "MouseMotionCoalescer.h"
+#include <algorithm>
+
+static size_t StepsFor(int64_t delta, int maxDelta)
+{
+    uint64_t magnitude = delta < 0 ? static_cast<uint64_t>(-delta) : static_cast<uint64_t>(delta);
+    return static_cast<size_t>((magnitude + maxDelta - 1) / maxDelta);
+}
+
+MouseMotionCoalescer::MouseMotionCoalescer(int maxDeltaPerReport)
+    : m_maxDelta(std::clamp(maxDeltaPerReport, 1, m_maxHighResolutionDeltaPerReport))
+{
+}
+
+void MouseMotionCoalescer::AddMotion(int dx, int dy, int wheel, int pan)
+{
+    m_dx += dx;
+    m_dy += dy;
+    m_wheel += wheel;
+    m_pan += pan;
+}
+
+size_t MouseMotionCoalescer::PendingReportCount() const
+{
+    return std::max({ StepsFor(m_dx, m_maxDelta), StepsFor(m_dy, m_maxDelta),
+        StepsFor(m_wheel, m_maxDelta), StepsFor(m_pan, m_maxDelta) });
+}
+
+int16_t MouseMotionCoalescer::TakeStep(int64_t& remaining) const
+{
+    int64_t step = std::clamp<int64_t>(remaining, -m_maxDelta, m_maxDelta);
+    remaining -= step;
+    return static_cast<int16_t>(step);
+}
+
+bool MouseMotionCoalescer::NextStep(int16_t& dx, int16_t& dy, int16_t& wheel, int16_t& pan)
+{
+    if (!HasPending())
+        return false;
+
+    // Each axis is clamped on its own, so the axis with the largest delta sets
+    // the report count and the others finish early without extra reports.
+    dx = TakeStep(m_dx);
+    dy = TakeStep(m_dy);
+    wheel = TakeStep(m_wheel);
+    pan = TakeStep(m_pan);
+    return true;
+}
+
+void MouseMotionCoalescer::Clear()
+{
+    m_dx = 0;
+    m_dy = 0;
+    m_wheel = 0;
+    m_pan = 0;
+}
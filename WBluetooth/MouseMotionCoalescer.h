@@ -0,0 +1,42 @@
+#ifndef MOUSE_MOTION_COALESCER_H
+#define MOUSE_MOTION_COALESCER_H
+
+#include <cstdint>
+#include <cstddef>
+
+// Accumulates relative motion between transmit opportunities and hands it out
+// again as report-sized steps. Every step fits the range of the mouse report
+// (-127..127 for the standard profile), and the remainder stays pending until
+// it has all been sent.
+class MouseMotionCoalescer
+{
+public:
+    static constexpr int m_maxDeltaPerReport = 127;
+    static constexpr int m_maxHighResolutionDeltaPerReport = 32767;
+
+    explicit MouseMotionCoalescer(int maxDeltaPerReport = m_maxDeltaPerReport);
+
+    void AddMotion(int dx, int dy, int wheel, int pan = 0);
+
+    bool HasPending() const { return m_dx != 0 || m_dy != 0 || m_wheel != 0 || m_pan != 0; }
+    int MaxDeltaPerReport() const { return m_maxDelta; }
+
+    // Minimum number of reports needed to carry the pending motion.
+    size_t PendingReportCount() const;
+
+    // Takes the next step off the pending motion. Returns false when nothing is pending.
+    bool NextStep(int16_t& dx, int16_t& dy, int16_t& wheel, int16_t& pan);
+
+    void Clear();
+
+private:
+    int16_t TakeStep(int64_t& remaining) const;
+
+    int m_maxDelta;
+    int64_t m_dx = 0;
+    int64_t m_dy = 0;
+    int64_t m_wheel = 0;
+    int64_t m_pan = 0;
+};
+
+#endif // MOUSE_MOTION_COALESCER_H
@@ -0,0 +1,102 @@
+#include "MouseReportEngine.h"
+#include <algorithm>
+#include <array>
+
+MouseReportEngine::MouseReportEngine(HidReportSink& sink, MouseReportProfile profile)
+    : m_sink(sink)
+    , m_profile(profile)
+    , m_buttonMask(profile == MouseReportProfile::HighResolution ? 0x1F : 0x03)
+    , m_reportSize(profile == MouseReportProfile::HighResolution ? m_sizeOfHighResolutionMouseReportDataInBytes
+                                                                 : m_sizeOfMouseReportDataInBytes)
+    , m_motion(profile == MouseReportProfile::HighResolution ? MouseMotionCoalescer::m_maxHighResolutionDeltaPerReport
+                                                             : MouseMotionCoalescer::m_maxDeltaPerReport)
+{
+}
+
+void MouseReportEngine::Move(int dx, int dy, int wheel, int pan)
+{
+    AddMotion(dx, dy, wheel, pan);
+    FlushMotion();
+}
+
+void MouseReportEngine::Press(uint8_t buttons)
+{
+    SetButtons(m_buttons | buttons);
+}
+
+void MouseReportEngine::Release(uint8_t buttons)
+{
+    SetButtons(m_buttons & ~buttons);
+}
+
+void MouseReportEngine::Click(uint8_t buttons)
+{
+    uint8_t held = m_buttons;
+    SetButtons(held | buttons);
+    // The sink holds the release back for the hold time; the caller moves on.
+    SendMouseState(held & ~buttons, 0, 0, 0, 0, m_clickHoldTime);
+}
+
+void MouseReportEngine::AddMotion(int dx, int dy, int wheel, int pan)
+{
+    // No pan axis in the standard report: it would only cost empty reports.
+    m_motion.AddMotion(dx, dy, wheel, m_profile == MouseReportProfile::HighResolution ? pan : 0);
+}
+
+void MouseReportEngine::FlushMotion()
+{
+    if (!m_sink.IsReady(HidReportId::Mouse))
+    {
+        m_motion.Clear();
+        return;
+    }
+
+    int16_t dx = 0, dy = 0, wheel = 0, pan = 0;
+    while (m_motion.NextStep(dx, dy, wheel, pan))
+    {
+        SendMouseState(m_buttons, dx, dy, wheel, pan);
+    }
+}
+
+void MouseReportEngine::SendMotionSequence(const MotionStep* steps, size_t count)
+{
+    FlushMotion();
+    if (count == 0 || !m_sink.IsReady(HidReportId::Mouse))
+        return;
+
+    // Delays are taken against the start, so a sink that blocks for them does
+    // not add its own wait on top of the next step's.
+    auto start = std::chrono::steady_clock::now();
+    int limit = m_motion.MaxDeltaPerReport();
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto delay = std::chrono::duration_cast<std::chrono::microseconds>(
+            start + steps[i].at - std::chrono::steady_clock::now());
+        SendMouseState(m_buttons, std::clamp<int>(steps[i].dx, -limit, limit), std::clamp<int>(steps[i].dy, -limit, limit), 0, 0,
+            std::max(delay, std::chrono::microseconds::zero()));
+    }
+}
+
+void MouseReportEngine::SetButtons(uint8_t buttons)
+{
+    // Motion gathered under the old button state must not bleed into the new one.
+    FlushMotion();
+    SendMouseState(buttons, 0, 0, 0, 0);
+}
+
+void MouseReportEngine::SendMouseState(uint8_t buttons, int dx, int dy, int wheel, int pan,
+    std::chrono::microseconds delay)
+{
+    if (!m_sink.IsReady(HidReportId::Mouse))
+        return;
+
+    std::array<uint8_t, m_sizeOfHighResolutionMouseReportDataInBytes> report;
+    PackMouseReport({ static_cast<uint8_t>(buttons & m_buttonMask), dx, dy, wheel, pan }, report.data(), m_reportSize);
+
+    m_buttons = buttons & m_buttonMask;
+
+    if (delay.count() > 0)
+        m_sink.SendReportAfter(HidReportId::Mouse, report.data(), m_reportSize, delay);
+    else
+        m_sink.SendReport(HidReportId::Mouse, report.data(), m_reportSize);
+}
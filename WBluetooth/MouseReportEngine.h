@@ -0,0 +1,68 @@
+#ifndef MOUSE_REPORT_ENGINE_H
+#define MOUSE_REPORT_ENGINE_H
+
+#include "HidReportSink.h"
+#include "HidReportMaps.h"
+#include "InputEvent.h"
+#include "MouseMotionCoalescer.h"
+#include "PointerTrajectory.h"
+#include <chrono>
+#include <cstdint>
+
+enum class MouseReportProfile : uint8_t
+{
+    Standard,       // two buttons, 8-bit X, Y and wheel (HidReportMaps::Mouse)
+    HighResolution  // five buttons, 16-bit X, Y, wheel and pan (HidReportMaps::HighResolutionMouse)
+};
+
+// Mouse report generation, independent of the transport.
+class MouseReportEngine
+{
+public:
+    static constexpr uint32_t m_sizeOfMouseReportDataInBytes =
+        HidDescriptor::InputReportBits(HidReportMaps::Mouse, HidReportMaps::MouseReportId) / 8;
+    static constexpr uint32_t m_sizeOfHighResolutionMouseReportDataInBytes =
+        HidDescriptor::InputReportBits(HidReportMaps::HighResolutionMouse, HidReportMaps::MouseReportId) / 8;
+    static constexpr std::chrono::milliseconds m_clickHoldTime{ 40 };
+
+    explicit MouseReportEngine(HidReportSink& sink, MouseReportProfile profile = MouseReportProfile::Standard);
+
+    MouseReportProfile GetProfile() const { return m_profile; }
+    // Largest delta per axis one report carries.
+    int MaxDeltaPerReport() const { return m_motion.MaxDeltaPerReport(); }
+
+    void Move(int dx, int dy, int wheel = 0, int pan = 0);
+    // Buttons are MouseButton masks; the standard profile ignores all but
+    // Left and Right, and pan.
+    void Press(uint8_t buttons = MouseButton::Left);
+    void Release(uint8_t buttons = MouseButton::Left);
+    void Click(uint8_t buttons = MouseButton::Left);
+    uint8_t GetButtons() const { return m_buttons; }
+
+    // Motion is accumulated by AddMotion and only goes out on FlushMotion,
+    // split into as few reports as the profile's deltas allow.
+    void AddMotion(int dx, int dy, int wheel = 0, int pan = 0);
+    void FlushMotion();
+    bool HasPendingMotion() const { return m_motion.HasPending(); }
+    size_t PendingMotionReportCount() const { return m_motion.PendingReportCount(); }
+
+    // Sends a compiled trajectory, each step at its offset from now, with the
+    // buttons held as they are.
+    void SendMotionSequence(const MotionStep* steps, size_t count);
+
+private:
+    void SendMouseState(uint8_t buttons, int dx, int dy, int wheel, int pan,
+        std::chrono::microseconds delay = std::chrono::microseconds::zero());
+    void SetButtons(uint8_t buttons);
+
+    HidReportSink& m_sink;
+    MouseReportProfile m_profile;
+    uint8_t m_buttonMask;
+    size_t m_reportSize;
+    MouseMotionCoalescer m_motion;
+
+    // State Variables
+    uint8_t m_buttons = 0;
+};
+
+#endif // MOUSE_REPORT_ENGINE_H
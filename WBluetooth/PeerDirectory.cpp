@@ -0,0 +1,127 @@
+#include "PeerDirectory.h"
+#include <algorithm>
+
+PeerDirectory::PeerDirectory(Resolver resolver)
+    : m_resolver(std::move(resolver))
+{
+    m_resolverThread = std::thread(&PeerDirectory::ResolverLoop, this);
+}
+
+PeerDirectory::~PeerDirectory()
+{
+    {
+        std::scoped_lock lock(m_mutex);
+        m_running = false;
+    }
+    m_wakeCondition.notify_one();
+    if (m_resolverThread.joinable())
+        m_resolverThread.join();
+}
+
+void PeerDirectory::SetResolvedHandler(ResolvedHandler handler)
+{
+    std::scoped_lock lock(m_mutex);
+    m_resolvedHandler = std::move(handler);
+}
+
+void PeerDirectory::ConnectLocked(const std::string& deviceId)
+{
+    if (m_peers.count(deviceId) != 0)
+        return;
+
+    auto& entry = m_peers[deviceId];
+    entry.generation = ++m_nextGeneration;
+    m_pending.emplace_back(deviceId, entry.generation);
+}
+
+void PeerDirectory::SetConnected(const std::vector<std::string>& deviceIds)
+{
+    {
+        std::scoped_lock lock(m_mutex);
+        for (auto it = m_peers.begin(); it != m_peers.end();)
+        {
+            if (std::find(deviceIds.begin(), deviceIds.end(), it->first) == deviceIds.end())
+                it = m_peers.erase(it);
+            else
+                ++it;
+        }
+        for (const auto& deviceId : deviceIds)
+            ConnectLocked(deviceId);
+    }
+    m_wakeCondition.notify_one();
+}
+
+std::vector<PeerInfo> PeerDirectory::GetPeers() const
+{
+    std::scoped_lock lock(m_mutex);
+    std::vector<PeerInfo> peers;
+    peers.reserve(m_peers.size());
+    for (const auto& [deviceId, entry] : m_peers)
+        peers.push_back({ deviceId, entry.name, entry.resolved, entry.resolveTime });
+    return peers;
+}
+
+void PeerDirectory::WaitIdle()
+{
+    std::unique_lock lock(m_mutex);
+    m_idleCondition.wait(lock, [this] { return !m_running || (m_pending.empty() && !m_resolving); });
+}
+
+void PeerDirectory::ResolverLoop()
+{
+    std::unique_lock lock(m_mutex);
+    for (;;)
+    {
+        m_wakeCondition.wait(lock, [this] { return !m_running || !m_pending.empty(); });
+        if (!m_running)
+            break;
+
+        auto [deviceId, generation] = std::move(m_pending.front());
+        m_pending.pop_front();
+        auto it = m_peers.find(deviceId);
+        if (it == m_peers.end() || it->second.generation != generation)
+        {
+            // Disconnected (and maybe reconnected) since it was queued.
+            if (m_pending.empty())
+                m_idleCondition.notify_all();
+            continue;
+        }
+
+        m_resolving = true;
+        lock.unlock();
+
+        auto start = std::chrono::steady_clock::now();
+        std::string name;
+        try
+        {
+            name = m_resolver(deviceId);
+        }
+        catch (...)
+        {
+            // Leave the name empty; the device may be gone already.
+        }
+        auto resolveTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+        lock.lock();
+        it = m_peers.find(deviceId);
+        if (it != m_peers.end() && it->second.generation == generation)
+        {
+            it->second.name = name;
+            it->second.resolved = true;
+            it->second.resolveTime = resolveTime;
+
+            if (m_resolvedHandler)
+            {
+                PeerInfo peer{ deviceId, name, true, resolveTime };
+                auto handler = m_resolvedHandler;
+                lock.unlock();
+                handler(peer);
+                lock.lock();
+            }
+        }
+        m_resolving = false;
+        if (m_pending.empty())
+            m_idleCondition.notify_all();
+    }
+    m_idleCondition.notify_all();
+}
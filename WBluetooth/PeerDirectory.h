@@ -0,0 +1,71 @@
+#ifndef PEER_DIRECTORY_H
+#define PEER_DIRECTORY_H
+
+#include "BleEmulatorTypes.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Names of the connected centrals, keyed by device ID. Connection changes only
+// touch the cache; lookups run on a resolver thread of their own, so callers
+// such as WinRT event handlers never wait for one. A device that disconnects is
+// dropped from the cache, and a lookup still running for it is thrown away.
+class PeerDirectory
+{
+public:
+    // Blocking lookup of a device's name, called on the resolver thread only.
+    using Resolver = std::function<std::string(const std::string& deviceId)>;
+    using ResolvedHandler = std::function<void(const PeerInfo& peer)>;
+
+    explicit PeerDirectory(Resolver resolver);
+    ~PeerDirectory();
+
+    PeerDirectory(const PeerDirectory&) = delete;
+    PeerDirectory& operator=(const PeerDirectory&) = delete;
+
+    // Called on the resolver thread after each lookup of a still connected device.
+    void SetResolvedHandler(ResolvedHandler handler);
+
+    // Replaces the set of connected devices: new ones are queued for lookup,
+    // missing ones are invalidated.
+    void SetConnected(const std::vector<std::string>& deviceIds);
+
+    std::vector<PeerInfo> GetPeers() const;
+    // Waits until no lookup is queued or running.
+    void WaitIdle();
+
+private:
+    struct Entry {
+        std::string name;
+        bool resolved = false;
+        std::chrono::microseconds resolveTime{ 0 };
+        uint64_t generation = 0;
+    };
+
+    void ConnectLocked(const std::string& deviceId);
+    void ResolverLoop();
+
+    Resolver m_resolver;
+    ResolvedHandler m_resolvedHandler;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wakeCondition;
+    std::condition_variable m_idleCondition;
+    std::map<std::string, Entry> m_peers;
+    // Pending lookups with the generation of the entry they were queued for.
+    std::deque<std::pair<std::string, uint64_t>> m_pending;
+    uint64_t m_nextGeneration = 0;
+    bool m_resolving = false;
+    bool m_running = true;
+
+    std::thread m_resolverThread;
+};
+
+#endif // PEER_DIRECTORY_H
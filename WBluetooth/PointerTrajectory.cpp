@@ -0,0 +1,119 @@
+#include "PointerTrajectory.h"
+#include "MouseMotionCoalescer.h"
+#include <algorithm>
+#include <cmath>
+
+// Each cubic segment is flattened into this many straight pieces before the
+// path is measured; plenty at the size a pointer travels on screen.
+static constexpr int BezierPiecesPerSegment = 32;
+
+static PointerPoint CubicAt(const PointerPoint& p0, const PointerPoint& p1, const PointerPoint& p2,
+    const PointerPoint& p3, double t)
+{
+    double u = 1.0 - t;
+    double a = u * u * u, b = 3 * u * u * t, c = 3 * u * t * t, d = t * t * t;
+    return { a * p0.x + b * p1.x + c * p2.x + d * p3.x, a * p0.y + b * p1.y + c * p2.y + d * p3.y };
+}
+
+static std::vector<PointerPoint> Flatten(const PointerPath& path)
+{
+    std::vector<PointerPoint> vertices{ { 0.0, 0.0 } };
+    if (path.shape == PointerPathShape::Polyline)
+    {
+        vertices.insert(vertices.end(), path.points.begin(), path.points.end());
+        return vertices;
+    }
+
+    vertices.reserve(1 + path.points.size() / 3 * BezierPiecesPerSegment);
+    for (size_t i = 0; i + 2 < path.points.size(); i += 3)
+    {
+        PointerPoint start = vertices.back();
+        for (int piece = 1; piece <= BezierPiecesPerSegment; ++piece)
+            vertices.push_back(CubicAt(start, path.points[i], path.points[i + 1], path.points[i + 2],
+                static_cast<double>(piece) / BezierPiecesPerSegment));
+    }
+    return vertices;
+}
+
+bool PointerTrajectory::IsValid(const PointerPath& path)
+{
+    if (path.duration.count() < 0 || path.duration > m_maxDuration)
+        return false;
+    if (path.shape == PointerPathShape::Bezier && path.points.size() % 3 != 0)
+        return false;
+
+    // A cubic segment is never longer than its control polygon.
+    double length = 0.0;
+    PointerPoint previous{ 0.0, 0.0 };
+    for (const auto& point : path.points)
+    {
+        if (!std::isfinite(point.x) || !std::isfinite(point.y))
+            return false;
+        length += std::hypot(point.x - previous.x, point.y - previous.y);
+        previous = point;
+    }
+    return length <= m_maxPathLength;
+}
+
+std::vector<MotionStep> PointerTrajectory::Compile(const PointerPath& path, std::chrono::microseconds reportInterval,
+    PointerPoint& remainder, int maxDeltaPerReport)
+{
+    std::vector<MotionStep> steps;
+    if (!IsValid(path))
+        return steps;
+
+    std::vector<PointerPoint> vertices = Flatten(path);
+    std::vector<double> lengths(vertices.size(), 0.0);
+    for (size_t i = 1; i < vertices.size(); ++i)
+        lengths[i] = lengths[i - 1] + std::hypot(vertices[i].x - vertices[i - 1].x, vertices[i].y - vertices[i - 1].y);
+    double totalLength = lengths.back();
+
+    auto pointAt = [&](double distance) {
+        size_t i = std::lower_bound(lengths.begin(), lengths.end(), distance) - lengths.begin();
+        if (i == 0)
+            return vertices.front();
+        if (i >= vertices.size())
+            return vertices.back();
+        double span = lengths[i] - lengths[i - 1];
+        double t = span > 0.0 ? (distance - lengths[i - 1]) / span : 1.0;
+        return PointerPoint{ vertices[i - 1].x + t * (vertices[i].x - vertices[i - 1].x),
+                             vertices[i - 1].y + t * (vertices[i].y - vertices[i - 1].y) };
+    };
+
+    // One sample per report interval, but never further apart than a report reaches.
+    int64_t sampleCount = 1;
+    if (reportInterval.count() > 0)
+        sampleCount = std::clamp<int64_t>((path.duration.count() + reportInterval.count() - 1) / reportInterval.count(),
+            1, m_maxTimedSampleCount);
+    const int64_t limit = std::clamp(maxDeltaPerReport, 2, MouseMotionCoalescer::m_maxHighResolutionDeltaPerReport);
+    double reach = static_cast<double>(limit) - 1.0;
+    sampleCount = std::max<int64_t>(sampleCount, static_cast<int64_t>(std::ceil(totalLength / reach)));
+
+    int64_t sentX = 0, sentY = 0;
+    auto stepTo = [&](int64_t targetX, int64_t targetY, std::chrono::microseconds at) {
+        int64_t dx = std::clamp(targetX - sentX, -limit, limit);
+        int64_t dy = std::clamp(targetY - sentY, -limit, limit);
+        if (dx == 0 && dy == 0)
+            return;
+        steps.push_back({ at, static_cast<int16_t>(dx), static_cast<int16_t>(dy) });
+        sentX += dx;
+        sentY += dy;
+    };
+
+    steps.reserve(static_cast<size_t>(sampleCount));
+    for (int64_t i = 1; i <= sampleCount; ++i)
+    {
+        PointerPoint sample = pointAt(totalLength * static_cast<double>(i) / static_cast<double>(sampleCount));
+        stepTo(std::llround(sample.x + remainder.x), std::llround(sample.y + remainder.y),
+            path.duration * i / sampleCount);
+    }
+
+    // Only reached if clamping held a sample back.
+    PointerPoint end{ vertices.back().x + remainder.x, vertices.back().y + remainder.y };
+    int64_t endX = std::llround(end.x), endY = std::llround(end.y);
+    while (sentX != endX || sentY != endY)
+        stepTo(endX, endY, path.duration);
+
+    remainder = { end.x - static_cast<double>(sentX), end.y - static_cast<double>(sentY) };
+    return steps;
+}
@@ -0,0 +1,65 @@
+#ifndef POINTER_TRAJECTORY_H
+#define POINTER_TRAJECTORY_H
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+struct PointerPoint
+{
+    double x;
+    double y;
+};
+
+enum class PointerPathShape : uint8_t
+{
+    Polyline,   // straight segments through every point
+    Bezier      // cubic segments: two control points, then the segment end
+};
+
+// Pointer travel relative to the current cursor position, which is the
+// implicit first point of the path.
+struct PointerPath
+{
+    PointerPathShape shape;
+    std::vector<PointerPoint> points;
+    std::chrono::microseconds duration;
+};
+
+// One mouse report of a compiled trajectory, due at an offset from its start.
+struct MotionStep
+{
+    std::chrono::microseconds at;
+    int16_t dx;
+    int16_t dy;
+};
+
+// Turns a pointer path into relative motion reports.
+//
+// The path is sampled at equal arc length, one sample per report interval of
+// the duration, or more if a sample would move further than a report can
+// carry. Each report moves to the rounded sample position, so rounding never
+// adds up along the path; steps that round to no motion are left out.
+class PointerTrajectory
+{
+public:
+    // Far beyond any screen, yet small enough that a compiled path fits in memory.
+    static constexpr double m_maxPathLength = 1 << 20;
+    static constexpr std::chrono::microseconds m_maxDuration = std::chrono::hours(1);
+    // Caps the samples taken for the duration; reach may still add more,
+    // at most m_maxPathLength / reach.
+    static constexpr int64_t m_maxTimedSampleCount = 1 << 20;
+
+    // remainder carries the sub-pixel part the previous trajectory could not
+    // send; it is added to this one and updated with what is left over.
+    // maxDeltaPerReport is the reach of the mouse profile in use.
+    static std::vector<MotionStep> Compile(const PointerPath& path, std::chrono::microseconds reportInterval,
+        PointerPoint& remainder, int maxDeltaPerReport = 127);
+
+    // Bezier paths need a whole number of segments, and no path may be longer
+    // than m_maxPathLength, measured along its control points, or take longer
+    // than m_maxDuration.
+    static bool IsValid(const PointerPath& path);
+};
+
+#endif // POINTER_TRAJECTORY_H
@@ -0,0 +1,83 @@
+#include "RedundantReportFilter.h"
+#include <algorithm>
+#include <cstring>
+
+RedundantReportFilter::RedundantReportFilter(HidReportSink& inner)
+    : m_inner(inner)
+{
+}
+
+bool RedundantReportFilter::IsReady(HidReportId reportId) const
+{
+    return m_inner.IsReady(reportId);
+}
+
+void RedundantReportFilter::Invalidate()
+{
+    m_invalidateRequested.store(true, std::memory_order_release);
+}
+
+bool RedundantReportFilter::IsRedundant(HidReportId reportId, const uint8_t* data, size_t size) const
+{
+    const auto& last = m_lastDelivered[static_cast<size_t>(reportId) % m_reportIdCount];
+    if (!last.valid || last.size != size)
+        return false;
+
+    MouseReportFields report;
+    if (reportId == HidReportId::Mouse && UnpackMouseReport(data, size, report))
+    {
+        return report.x == 0 && report.y == 0 && report.wheel == 0 && report.pan == 0 &&
+            report.buttons == last.data[offsetof(MouseInputReport, buttons)];
+    }
+
+    return std::memcmp(last.data.data(), data, size) == 0;
+}
+
+bool RedundantReportFilter::Admit(HidReportId reportId, const uint8_t* data, size_t size)
+{
+    auto index = static_cast<size_t>(reportId) % m_reportIdCount;
+
+    if (m_invalidateRequested.load(std::memory_order_relaxed) &&
+        m_invalidateRequested.exchange(false, std::memory_order_acquire))
+    {
+        for (auto& delivered : m_lastDelivered)
+            delivered.valid = false;
+    }
+
+    if (IsRedundant(reportId, data, size))
+    {
+        m_suppressedCounts[index].fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    m_sentCounts[index].fetch_add(1, std::memory_order_relaxed);
+
+    auto& last = m_lastDelivered[index];
+    last.size = std::min(size, last.data.size());
+    std::copy(data, data + last.size, last.data.begin());
+    last.valid = last.size == size;
+    return true;
+}
+
+void RedundantReportFilter::SendReport(HidReportId reportId, const uint8_t* data, size_t size)
+{
+    if (Admit(reportId, data, size))
+        m_inner.SendReport(reportId, data, size);
+}
+
+void RedundantReportFilter::SendReportAfter(HidReportId reportId, const uint8_t* data, size_t size, std::chrono::microseconds delay)
+{
+    // Checked against the report queued before it, which is what the host will
+    // have seen by the time this one goes out.
+    if (Admit(reportId, data, size))
+        m_inner.SendReportAfter(reportId, data, size, delay);
+}
+
+ReportCounters RedundantReportFilter::GetCounters(HidReportId reportId) const
+{
+    auto index = static_cast<size_t>(reportId) % m_reportIdCount;
+    return {
+        m_sentCounts[index].load(std::memory_order_relaxed),
+        m_suppressedCounts[index].load(std::memory_order_relaxed)
+    };
+}
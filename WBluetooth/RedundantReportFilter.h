@@ -0,0 +1,60 @@
+#ifndef REDUNDANT_REPORT_FILTER_H
+#define REDUNDANT_REPORT_FILTER_H
+
+#include "HidReportSink.h"
+#include "HidReports.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Sink decorator that drops reports which would not change anything on the host.
+//
+// Keyboard and consumer reports carry absolute state, so a report that is
+// byte-identical to the last one delivered on that report is redundant. Mouse
+// reports are relative: a repeated move is real motion, so only a report with
+// zero deltas and the buttons of the last delivered report is dropped.
+//
+// The filter sits in front of every central at once, so whoever adds or
+// resubscribes a central calls Invalidate(): the newcomer has seen none of
+// the reports delivered so far, and the next one must reach it even if it
+// repeats the last.
+class RedundantReportFilter : public HidReportSink
+{
+public:
+    explicit RedundantReportFilter(HidReportSink& inner);
+
+    bool IsReady(HidReportId reportId) const override;
+    void SendReport(HidReportId reportId, const uint8_t* data, size_t size) override;
+    void SendReportAfter(HidReportId reportId, const uint8_t* data, size_t size, std::chrono::microseconds delay) override;
+
+    // Forgets the last delivered reports. Any thread; takes effect before
+    // the next report is checked.
+    void Invalidate();
+
+    ReportCounters GetCounters(HidReportId reportId) const;
+
+private:
+    static constexpr size_t m_reportIdCount = HidReportIdCount;
+
+    struct DeliveredReport {
+        std::array<uint8_t, MaxHidReportSizeInBytes> data{};
+        size_t size = 0;
+        bool valid = false;
+    };
+
+    bool IsRedundant(HidReportId reportId, const uint8_t* data, size_t size) const;
+    // Counts the report and remembers it as delivered unless it is redundant.
+    bool Admit(HidReportId reportId, const uint8_t* data, size_t size);
+
+    HidReportSink& m_inner;
+
+    // Only touched from the thread that sends reports, which also carries
+    // out Invalidate() requests.
+    std::array<DeliveredReport, m_reportIdCount> m_lastDelivered{};
+    std::atomic<bool> m_invalidateRequested{ false };
+
+    std::array<std::atomic<uint64_t>, m_reportIdCount> m_sentCounts{};
+    std::array<std::atomic<uint64_t>, m_reportIdCount> m_suppressedCounts{};
+};
+
+#endif // REDUNDANT_REPORT_FILTER_H
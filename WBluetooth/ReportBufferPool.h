@@ -0,0 +1,112 @@
+#ifndef REPORT_BUFFER_POOL_H
+#define REPORT_BUFFER_POOL_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Recycles transport buffers so that sending a report does not allocate.
+// The pool is filled up front; if it ever runs dry it grows by one buffer and
+// counts that in GetAllocationCount(), which stays flat in steady state.
+template <typename T>
+class ReportBufferPool
+{
+public:
+    using Factory = std::function<T()>;
+
+    // Returns its buffer to the pool when destroyed.
+    class Lease
+    {
+    public:
+        Lease() = default;
+        Lease(ReportBufferPool* pool, T* buffer) : m_pool(pool), m_buffer(buffer) {}
+        Lease(Lease&& other) noexcept : m_pool(other.m_pool), m_buffer(other.m_buffer) { other.m_buffer = nullptr; }
+        Lease& operator=(Lease&& other) noexcept
+        {
+            if (this != &other)
+            {
+                Reset();
+                m_pool = other.m_pool;
+                m_buffer = other.m_buffer;
+                other.m_buffer = nullptr;
+            }
+            return *this;
+        }
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        ~Lease() { Reset(); }
+
+        T& operator*() const { return *m_buffer; }
+        T* operator->() const { return m_buffer; }
+        explicit operator bool() const { return m_buffer != nullptr; }
+
+        void Reset()
+        {
+            if (m_buffer)
+                m_pool->Release(m_buffer);
+            m_buffer = nullptr;
+        }
+
+    private:
+        ReportBufferPool* m_pool = nullptr;
+        T* m_buffer = nullptr;
+    };
+
+    ReportBufferPool(size_t capacity, Factory factory)
+        : m_factory(std::move(factory))
+    {
+        m_storage.reserve(capacity);
+        m_free.reserve(capacity);
+        for (size_t i = 0; i < capacity; ++i)
+        {
+            m_storage.push_back(std::make_unique<T>(m_factory()));
+            m_free.push_back(m_storage.back().get());
+        }
+    }
+
+    ReportBufferPool(const ReportBufferPool&) = delete;
+    ReportBufferPool& operator=(const ReportBufferPool&) = delete;
+
+    Lease Acquire()
+    {
+        std::scoped_lock lock(m_mutex);
+        if (m_free.empty())
+        {
+            m_storage.push_back(std::make_unique<T>(m_factory()));
+            m_free.reserve(m_storage.size());
+            m_allocationCount.fetch_add(1, std::memory_order_relaxed);
+            return Lease(this, m_storage.back().get());
+        }
+
+        T* buffer = m_free.back();
+        m_free.pop_back();
+        return Lease(this, buffer);
+    }
+
+    size_t Capacity() const
+    {
+        std::scoped_lock lock(m_mutex);
+        return m_storage.size();
+    }
+
+    // Buffers created after construction because the pool ran dry.
+    uint64_t GetAllocationCount() const { return m_allocationCount.load(std::memory_order_relaxed); }
+
+private:
+    void Release(T* buffer)
+    {
+        std::scoped_lock lock(m_mutex);
+        m_free.push_back(buffer);
+    }
+
+    Factory m_factory;
+    mutable std::mutex m_mutex;
+    std::vector<std::unique_ptr<T>> m_storage;
+    std::vector<T*> m_free;
+    std::atomic<uint64_t> m_allocationCount{ 0 };
+};
+
+#endif // REPORT_BUFFER_POOL_H
@@ -0,0 +1,285 @@
+#include "ReportFanOut.h"
+#include "InputLatency.h"
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <cstring>
+#include <thread>
+
+namespace
+{
+    struct QueuedReport {
+        HidReportId reportId;
+        uint8_t size;
+        std::array<uint8_t, MaxHidReportSizeInBytes> data;
+        ReportFanOut::Clock::time_point queuedAt;
+        uint64_t origin;    // see InputLatency.h
+    };
+
+    // Adds the motion of a mouse report to one that has not been sent yet, if
+    // the buttons agree and the sums still fit the report.
+    bool MergeMotion(QueuedReport& queued, const uint8_t* data, size_t size)
+    {
+        MouseReportFields pending, next;
+        if (queued.reportId != HidReportId::Mouse || queued.size != size ||
+            !UnpackMouseReport(queued.data.data(), queued.size, pending) || !UnpackMouseReport(data, size, next) ||
+            pending.buttons != next.buttons)
+            return false;
+
+        int32_t limit = MaxMouseDelta(size);
+        MouseReportFields merged{ pending.buttons, pending.x + next.x, pending.y + next.y,
+            pending.wheel + next.wheel, pending.pan + next.pan };
+        for (int32_t value : { merged.x, merged.y, merged.wheel, merged.pan })
+        {
+            if (value < -limit || value > limit)
+                return false;
+        }
+
+        PackMouseReport(merged, queued.data.data(), queued.size);
+        return true;
+    }
+}
+
+struct ReportFanOut::Client
+{
+    std::string id;
+    std::unique_ptr<HidReportSink> transport;
+    std::thread senderThread;
+
+    std::mutex mutex;
+    std::condition_variable wakeCondition;
+    std::condition_variable drainedCondition;
+    bool running = true;
+    bool sending = false;
+    // Ring of queued reports; preallocated so queueing never allocates.
+    std::vector<QueuedReport> queue;
+    size_t head = 0;
+    size_t count = 0;
+    size_t maxBacklog = 0;
+
+    std::atomic<uint64_t> delivered{ 0 };
+    std::atomic<uint64_t> dropped{ 0 };
+    std::atomic<uint64_t> coalesced{ 0 };
+    std::atomic<int64_t> latencySumNs{ 0 };
+    std::atomic<int64_t> latencyMaxNs{ 0 };
+
+    void Enqueue(HidReportId reportId, const uint8_t* data, size_t size, ClientOverflowPolicy policy, Clock::time_point now)
+    {
+        {
+            std::scoped_lock lock(mutex);
+            if (policy == ClientOverflowPolicy::Coalesce && count > 0 &&
+                MergeMotion(queue[(head + count - 1) % queue.size()], data, size))
+            {
+                coalesced.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+
+            if (count == queue.size())
+            {
+                head = (head + 1) % queue.size();
+                --count;
+                dropped.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            auto& slot = queue[(head + count) % queue.size()];
+            slot.reportId = reportId;
+            slot.size = static_cast<uint8_t>(size);
+            std::memcpy(slot.data.data(), data, size);
+            slot.queuedAt = now;
+            slot.origin = ReportOrigin::Current();
+            ++count;
+            maxBacklog = std::max(maxBacklog, count);
+        }
+        wakeCondition.notify_one();
+    }
+
+    void SenderLoop()
+    {
+        std::unique_lock lock(mutex);
+        for (;;)
+        {
+            wakeCondition.wait(lock, [this] { return !running || count > 0; });
+            if (!running)
+                break;
+
+            QueuedReport report = queue[head];
+            head = (head + 1) % queue.size();
+            --count;
+            sending = true;
+            lock.unlock();
+
+            {
+                ReportOrigin::Scope scope(report.origin);
+                transport->SendReport(report.reportId, report.data.data(), report.size);
+            }
+
+            int64_t latency = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - report.queuedAt).count();
+            latencySumNs.fetch_add(latency, std::memory_order_relaxed);
+            if (latency > latencyMaxNs.load(std::memory_order_relaxed))
+                latencyMaxNs.store(latency, std::memory_order_relaxed);
+            delivered.fetch_add(1, std::memory_order_relaxed);
+
+            lock.lock();
+            sending = false;
+            if (count == 0)
+                drainedCondition.notify_all();
+        }
+        drainedCondition.notify_all();
+    }
+};
+
+ReportFanOut::ReportFanOut(size_t queueCapacity, ClientOverflowPolicy policy)
+    : m_queueCapacity(std::max<size_t>(queueCapacity, 1))
+    , m_policy(policy)
+{
+}
+
+ReportFanOut::~ReportFanOut()
+{
+    std::vector<std::shared_ptr<Client>> clients;
+    {
+        std::scoped_lock lock(m_mutex);
+        clients.swap(m_clients);
+    }
+    for (auto& client : clients)
+        StopClient(*client);
+}
+
+void ReportFanOut::StopClient(Client& client)
+{
+    {
+        std::scoped_lock lock(client.mutex);
+        client.running = false;
+    }
+    client.wakeCondition.notify_one();
+    if (client.senderThread.joinable())
+        client.senderThread.join();
+}
+
+void ReportFanOut::AddClient(const std::string& clientId, std::unique_ptr<HidReportSink> transport)
+{
+    if (!transport)
+        return;
+
+    auto client = std::make_shared<Client>();
+    client->id = clientId;
+    client->transport = std::move(transport);
+    client->queue.resize(m_queueCapacity);
+    client->senderThread = std::thread(&Client::SenderLoop, client.get());
+
+    std::shared_ptr<Client> replaced;
+    {
+        std::scoped_lock lock(m_mutex);
+        auto it = std::find_if(m_clients.begin(), m_clients.end(),
+            [&](const auto& existing) { return existing->id == clientId; });
+        if (it != m_clients.end())
+        {
+            replaced = std::move(*it);
+            *it = std::move(client);
+        }
+        else
+        {
+            m_clients.push_back(std::move(client));
+        }
+    }
+    if (replaced)
+        StopClient(*replaced);
+}
+
+void ReportFanOut::RemoveClient(const std::string& clientId, const HidReportSink* transport)
+{
+    std::shared_ptr<Client> removed;
+    {
+        std::scoped_lock lock(m_mutex);
+        auto it = std::find_if(m_clients.begin(), m_clients.end(), [&](const auto& existing) {
+            return existing->id == clientId && (!transport || existing->transport.get() == transport);
+        });
+        if (it == m_clients.end())
+            return;
+        removed = std::move(*it);
+        m_clients.erase(it);
+    }
+    StopClient(*removed);
+}
+
+std::vector<std::string> ReportFanOut::GetClientIds() const
+{
+    std::scoped_lock lock(m_mutex);
+    std::vector<std::string> ids;
+    ids.reserve(m_clients.size());
+    for (const auto& client : m_clients)
+        ids.push_back(client->id);
+    return ids;
+}
+
+void ReportFanOut::SetOverflowPolicy(ClientOverflowPolicy policy)
+{
+    m_policy.store(policy, std::memory_order_relaxed);
+}
+
+bool ReportFanOut::IsReady(HidReportId reportId) const
+{
+    std::scoped_lock lock(m_mutex);
+    return std::any_of(m_clients.begin(), m_clients.end(),
+        [reportId](const auto& client) { return client->transport->IsReady(reportId); });
+}
+
+void ReportFanOut::SendReport(HidReportId reportId, const uint8_t* data, size_t size)
+{
+    if (size > MaxHidReportSizeInBytes)
+        return;
+
+    auto policy = m_policy.load(std::memory_order_relaxed);
+    auto now = Clock::now();
+    std::scoped_lock lock(m_mutex);
+    for (const auto& client : m_clients)
+    {
+        if (client->transport->IsReady(reportId))
+            client->Enqueue(reportId, data, size, policy, now);
+    }
+}
+
+void ReportFanOut::Flush()
+{
+    std::vector<std::shared_ptr<Client>> clients;
+    {
+        std::scoped_lock lock(m_mutex);
+        clients = m_clients;
+    }
+    for (auto& client : clients)
+    {
+        std::unique_lock lock(client->mutex);
+        client->drainedCondition.wait(lock, [&] { return !client->running || (client->count == 0 && !client->sending); });
+    }
+}
+
+std::vector<ClientStats> ReportFanOut::GetClientStats() const
+{
+    std::scoped_lock lock(m_mutex);
+    std::vector<ClientStats> stats;
+    stats.reserve(m_clients.size());
+    for (const auto& client : m_clients)
+    {
+        size_t backlog, maxBacklog;
+        {
+            std::scoped_lock clientLock(client->mutex);
+            backlog = client->count;
+            maxBacklog = client->maxBacklog;
+        }
+        uint64_t delivered = client->delivered.load(std::memory_order_relaxed);
+        int64_t latencySum = client->latencySumNs.load(std::memory_order_relaxed);
+        stats.push_back({
+            client->id,
+            delivered,
+            client->dropped.load(std::memory_order_relaxed),
+            client->coalesced.load(std::memory_order_relaxed),
+            backlog,
+            maxBacklog,
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::nanoseconds(delivered ? latencySum / static_cast<int64_t>(delivered) : 0)),
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::nanoseconds(client->latencyMaxNs.load(std::memory_order_relaxed)))
+        });
+    }
+    return stats;
+}
@@ -0,0 +1,66 @@
+#ifndef REPORT_FAN_OUT_H
+#define REPORT_FAN_OUT_H
+
+#include "BleEmulatorTypes.h"
+#include "HidReportSink.h"
+#include "HidReports.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Sink that delivers every report to several centrals at once. Each client
+// has its own transport, bounded queue and sender thread, so SendReport()
+// only copies the report into the queues and a slow central falls behind on
+// its own instead of holding up the others.
+class ReportFanOut : public HidReportSink
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr size_t m_defaultQueueCapacity = 64;
+
+    explicit ReportFanOut(size_t queueCapacity = m_defaultQueueCapacity,
+        ClientOverflowPolicy policy = ClientOverflowPolicy::Coalesce);
+    ~ReportFanOut();
+
+    ReportFanOut(const ReportFanOut&) = delete;
+    ReportFanOut& operator=(const ReportFanOut&) = delete;
+
+    // Starts delivering to transport on its own thread, replacing any client
+    // with the same id. A client only gets reports its transport is ready for.
+    void AddClient(const std::string& clientId, std::unique_ptr<HidReportSink> transport);
+    // Stops the client's thread; reports still queued for it are discarded.
+    // Given a transport, only a client still delivering to it is removed, so
+    // a late removal cannot take out a client added again under the same id.
+    void RemoveClient(const std::string& clientId, const HidReportSink* transport = nullptr);
+    std::vector<std::string> GetClientIds() const;
+
+    // Applies to current and future clients.
+    void SetOverflowPolicy(ClientOverflowPolicy policy);
+
+    // Ready as long as one client is.
+    bool IsReady(HidReportId reportId) const override;
+    void SendReport(HidReportId reportId, const uint8_t* data, size_t size) override;
+
+    // Waits until every client has handed the reports queued before the call to its transport.
+    void Flush();
+
+    std::vector<ClientStats> GetClientStats() const;
+
+private:
+    struct Client;
+
+    static void StopClient(Client& client);
+
+    size_t m_queueCapacity;
+    std::atomic<ClientOverflowPolicy> m_policy;
+
+    mutable std::mutex m_mutex;
+    std::vector<std::shared_ptr<Client>> m_clients;
+};
+
+#endif // REPORT_FAN_OUT_H
@@ -0,0 +1,296 @@
+#include "ReportScheduler.h"
+#include "InputLatency.h"
+#include <algorithm>
+
+ReportScheduler::ReportScheduler(HidReportSink& inner, std::chrono::microseconds connectionInterval,
+    size_t reportsPerConnectionEvent)
+    : m_inner(inner)
+    , m_epoch(Clock::now())
+    , m_interval(std::max<Clock::duration>(connectionInterval, std::chrono::microseconds(1)))
+    , m_reportsPerEvent(std::max<size_t>(reportsPerConnectionEvent, 1))
+    , m_maxBacklogCount(m_reportsPerEvent * m_maxBacklogEvents)
+{
+    for (auto& slot : m_wheel)
+        slot.reserve(m_reportsPerEvent);
+    m_due.reserve(m_reportsPerEvent);
+}
+
+ReportScheduler::~ReportScheduler()
+{
+    Stop();
+}
+
+void ReportScheduler::Start()
+{
+    if (m_running.exchange(true))
+        return;
+
+    m_schedulerThread = std::thread(&ReportScheduler::SchedulerLoop, this);
+}
+
+void ReportScheduler::Stop()
+{
+    {
+        std::scoped_lock lock(m_mutex);
+        if (!m_running.exchange(false))
+            return;
+        m_wakeCondition.notify_one();
+        m_roomCondition.notify_all();
+    }
+    if (m_schedulerThread.joinable())
+        m_schedulerThread.join();
+}
+
+bool ReportScheduler::IsReady(HidReportId reportId) const
+{
+    return m_inner.IsReady(reportId);
+}
+
+void ReportScheduler::SendReport(HidReportId reportId, const uint8_t* data, size_t size)
+{
+    SendReportAfter(reportId, data, size, std::chrono::microseconds::zero());
+}
+
+void ReportScheduler::SendReportAfter(HidReportId reportId, const uint8_t* data, size_t size, std::chrono::microseconds delay)
+{
+    if (size > MaxHidReportSizeInBytes)
+        return;
+
+    // A deliberate delay is not latency: the report counts from when it is due.
+    uint64_t origin = ReportOrigin::Current();
+    if (origin != 0)
+        origin += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(delay).count());
+
+    size_t reportIndex = static_cast<size_t>(reportId) % m_reportIdCount;
+    bool backlog = delay <= std::chrono::microseconds::zero();
+
+    std::unique_lock lock(m_mutex);
+    size_t& backlogCount = m_backlogCount[reportIndex];
+    if (backlog && m_running.load(std::memory_order_relaxed) && backlogCount >= m_maxBacklogCount)
+    {
+        auto start = Clock::now();
+        m_roomCondition.wait(lock, [&] {
+            return !m_running.load(std::memory_order_relaxed) || backlogCount < m_maxBacklogCount;
+        });
+        m_blockedCount.fetch_add(1, std::memory_order_relaxed);
+        m_blockedNs.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count(),
+            std::memory_order_relaxed);
+    }
+
+    if (!m_running.load(std::memory_order_relaxed))
+    {
+        lock.unlock();
+        ReportOrigin::Scope scope(origin);
+        m_inner.SendReportAfter(reportId, data, size, delay);
+        return;
+    }
+
+    auto now = Clock::now();
+    // While idle the scheduler thread stops advancing; catch up before placing anything.
+    uint64_t earliest = std::max(m_nextEvent, FirstEventAtOrAfter(now));
+    if (DeadlineOf(earliest) <= now)
+        ++earliest;
+
+    auto& lastEvent = m_lastEventForReport[reportIndex];
+    uint64_t event = std::max({ earliest, FirstEventAtOrAfter(now + delay), lastEvent });
+    while (CountInEvent(event) >= m_reportsPerEvent)
+    {
+        ++event;
+        m_deferredCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    lastEvent = event;
+
+    if (m_pendingCount == 0)
+        m_nextEvent = earliest;
+
+    ScheduledReport report;
+    report.event = event;
+    report.origin = origin;
+    report.reportId = reportId;
+    report.backlog = backlog;
+    report.size = static_cast<uint8_t>(size);
+    std::copy(data, data + size, report.data.begin());
+    m_wheel[event % m_wheelSlotCount].push_back(report);
+    if (backlog)
+        ++backlogCount;
+
+    if (m_pendingCount++ == 0 || event < m_waitingForEvent)
+    {
+        m_wakeEarly = true;
+        m_wakeCondition.notify_one();
+    }
+}
+
+void ReportScheduler::SetConnectionInterval(std::chrono::microseconds interval)
+{
+    std::scoped_lock lock(m_mutex);
+    // Events already passed keep their old spacing.
+    m_epoch = DeadlineOf(m_nextEvent);
+    m_epochEvent = m_nextEvent;
+    m_interval = std::max<Clock::duration>(interval, std::chrono::microseconds(1));
+}
+
+std::chrono::microseconds ReportScheduler::GetConnectionInterval() const
+{
+    std::scoped_lock lock(m_mutex);
+    return std::chrono::duration_cast<std::chrono::microseconds>(m_interval);
+}
+
+void ReportScheduler::Flush()
+{
+    std::unique_lock lock(m_mutex);
+    m_drainedCondition.wait(lock, [&] {
+        return !m_running.load(std::memory_order_relaxed) || (m_pendingCount == 0 && !m_sending);
+    });
+}
+
+SchedulerStats ReportScheduler::GetStats() const
+{
+    uint64_t events = m_eventCount.load(std::memory_order_relaxed);
+    int64_t jitterSum = m_jitterSumNs.load(std::memory_order_relaxed);
+    return {
+        events,
+        m_reportCount.load(std::memory_order_relaxed),
+        m_deferredCount.load(std::memory_order_relaxed),
+        m_blockedCount.load(std::memory_order_relaxed),
+        std::chrono::nanoseconds(m_blockedNs.load(std::memory_order_relaxed)),
+        std::chrono::nanoseconds(events ? jitterSum / static_cast<int64_t>(events) : 0),
+        std::chrono::nanoseconds(m_jitterMaxNs.load(std::memory_order_relaxed))
+    };
+}
+
+uint64_t ReportScheduler::FirstEventAtOrAfter(Clock::time_point time) const
+{
+    if (time <= m_epoch)
+        return m_epochEvent;
+
+    auto elapsed = time - m_epoch;
+    return m_epochEvent + static_cast<uint64_t>((elapsed + m_interval - Clock::duration(1)) / m_interval);
+}
+
+ReportScheduler::Clock::time_point ReportScheduler::DeadlineOf(uint64_t event) const
+{
+    return m_epoch + m_interval * static_cast<int64_t>(event - m_epochEvent);
+}
+
+size_t ReportScheduler::CountInEvent(uint64_t event) const
+{
+    const auto& slot = m_wheel[event % m_wheelSlotCount];
+    return static_cast<size_t>(std::count_if(slot.begin(), slot.end(),
+        [event](const ScheduledReport& report) { return report.event == event; }));
+}
+
+uint64_t ReportScheduler::EarliestPendingEvent() const
+{
+    uint64_t earliest = UINT64_MAX;
+    for (const auto& slot : m_wheel)
+    {
+        for (const auto& report : slot)
+            earliest = std::min(earliest, report.event);
+    }
+    return earliest;
+}
+
+void ReportScheduler::TakeDueReports(uint64_t event)
+{
+    // Entries for later laps of the wheel stay where they are, in order.
+    auto& slot = m_wheel[event % m_wheelSlotCount];
+    auto later = std::stable_partition(slot.begin(), slot.end(),
+        [event](const ScheduledReport& report) { return report.event == event; });
+    m_due.insert(m_due.end(), slot.begin(), later);
+    slot.erase(slot.begin(), later);
+    m_pendingCount -= m_due.size();
+
+    bool room = false;
+    for (const auto& report : m_due)
+    {
+        if (report.backlog)
+        {
+            --m_backlogCount[static_cast<size_t>(report.reportId) % m_reportIdCount];
+            room = true;
+        }
+    }
+    if (room)
+        m_roomCondition.notify_all();
+}
+
+void ReportScheduler::SendDueReports()
+{
+    for (const auto& report : m_due)
+    {
+        ReportOrigin::Scope scope(report.origin);
+        m_inner.SendReport(report.reportId, report.data.data(), report.size);
+    }
+    m_reportCount.fetch_add(m_due.size(), std::memory_order_relaxed);
+    m_due.clear();
+}
+
+void ReportScheduler::SchedulerLoop()
+{
+    std::unique_lock lock(m_mutex);
+    while (m_running.load(std::memory_order_relaxed))
+    {
+        if (m_pendingCount == 0)
+        {
+            m_wakeCondition.wait(lock, [&] {
+                return !m_running.load(std::memory_order_relaxed) || m_pendingCount > 0;
+            });
+            continue;
+        }
+
+        // Events with nothing in them are skipped rather than waited out.
+        uint64_t target = std::max(m_nextEvent, EarliestPendingEvent());
+        auto deadline = DeadlineOf(target);
+        m_waitingForEvent = target;
+        m_wakeEarly = false;
+        auto wakeCheck = [&] { return !m_running.load(std::memory_order_relaxed) || m_wakeEarly; };
+        bool woken = m_wakeCondition.wait_until(lock, deadline - m_spinWindow, wakeCheck);
+        if (!woken && Clock::now() < deadline)
+        {
+            // Timer slack would make the event late; spin the last stretch off.
+            lock.unlock();
+            while (Clock::now() < deadline)
+                std::this_thread::yield();
+            lock.lock();
+            woken = wakeCheck();
+        }
+        m_waitingForEvent = UINT64_MAX;
+        if (!m_running.load(std::memory_order_relaxed))
+            break;
+        if (woken)
+            continue;
+        auto woke = Clock::now();
+        m_nextEvent = target;
+
+        TakeDueReports(m_nextEvent++);
+        if (m_due.empty())
+            continue;
+
+        m_sending = true;
+        lock.unlock();
+
+        int64_t jitter = std::chrono::duration_cast<std::chrono::nanoseconds>(woke - deadline).count();
+        m_eventCount.fetch_add(1, std::memory_order_relaxed);
+        m_jitterSumNs.fetch_add(jitter, std::memory_order_relaxed);
+        if (jitter > m_jitterMaxNs.load(std::memory_order_relaxed))
+            m_jitterMaxNs.store(jitter, std::memory_order_relaxed);
+        SendDueReports();
+
+        lock.lock();
+        m_sending = false;
+        if (m_pendingCount == 0)
+            m_drainedCondition.notify_all();
+    }
+
+    // Nothing is dropped on the way out: a held-back release must still reach the host.
+    while (m_pendingCount > 0)
+    {
+        m_nextEvent = std::max(m_nextEvent, EarliestPendingEvent());
+        TakeDueReports(m_nextEvent++);
+    }
+    lock.unlock();
+    SendDueReports();
+
+    lock.lock();
+    m_drainedCondition.notify_all();
+}
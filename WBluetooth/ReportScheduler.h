@@ -0,0 +1,127 @@
+#ifndef REPORT_SCHEDULER_H
+#define REPORT_SCHEDULER_H
+
+#include "HidReportSink.h"
+#include "HidReports.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Sink decorator that holds reports back until the next connection event and
+// hands them to the transport on deadlines spaced one connection interval
+// apart, so latency follows the link rather than OS timer slack.
+//
+// Pending reports sit in a timer wheel with one slot per connection event.
+// A report goes into the first event at or after its due time that still has
+// room and that is not earlier than the last report queued on the same ID.
+// The scheduler thread sleeps until shortly before each deadline, then spins
+// the rest of the way and records how late it woke.
+//
+// Reports sent for right away are capped per report ID at m_maxBacklogEvents
+// connection events' worth. Past that, SendReportAfter() waits for the link
+// to catch up, so a producer faster than the link backs up into the input
+// queue, where motion is merged and the backpressure policy applies, instead
+// of into latency here. Reports sent with a delay, such as trajectory steps
+// or a click's release, are already spaced out by their caller and do not
+// count: a long pointer move never holds up the keys submitted after it.
+class ReportScheduler : public HidReportSink
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr std::chrono::microseconds m_defaultConnectionInterval{ 7500 };
+    static constexpr size_t m_defaultReportsPerConnectionEvent = 4;
+    static constexpr size_t m_wheelSlotCount = 64;
+    static constexpr size_t m_maxBacklogEvents = 4;
+    // Sleeping is left this far ahead of a deadline; the remainder is spun.
+    static constexpr std::chrono::microseconds m_spinWindow{ 1000 };
+
+    explicit ReportScheduler(HidReportSink& inner,
+        std::chrono::microseconds connectionInterval = m_defaultConnectionInterval,
+        size_t reportsPerConnectionEvent = m_defaultReportsPerConnectionEvent);
+    ~ReportScheduler();
+
+    ReportScheduler(const ReportScheduler&) = delete;
+    ReportScheduler& operator=(const ReportScheduler&) = delete;
+
+    // Until Start(), reports pass straight through to the inner sink.
+    void Start();
+    // Sends whatever is still pending right away, then stops the thread.
+    void Stop();
+
+    bool IsReady(HidReportId reportId) const override;
+    void SendReport(HidReportId reportId, const uint8_t* data, size_t size) override;
+    void SendReportAfter(HidReportId reportId, const uint8_t* data, size_t size, std::chrono::microseconds delay) override;
+
+    // Takes effect from the next connection event on.
+    void SetConnectionInterval(std::chrono::microseconds interval);
+    std::chrono::microseconds GetConnectionInterval() const;
+
+    // Waits until every report queued before the call has been handed to the inner sink.
+    void Flush();
+
+    SchedulerStats GetStats() const;
+
+private:
+    static constexpr size_t m_reportIdCount = HidReportIdCount;
+
+    struct ScheduledReport {
+        uint64_t event;
+        uint64_t origin;    // see InputLatency.h, moved forward by the requested delay
+        HidReportId reportId;
+        bool backlog;       // sent for right away, counted against the cap
+        uint8_t size;
+        std::array<uint8_t, MaxHidReportSizeInBytes> data;
+    };
+
+    // Connection events are numbered from m_epochEvent, whose deadline is m_epoch.
+    uint64_t FirstEventAtOrAfter(Clock::time_point time) const;
+    Clock::time_point DeadlineOf(uint64_t event) const;
+    size_t CountInEvent(uint64_t event) const;
+    uint64_t EarliestPendingEvent() const;
+    void TakeDueReports(uint64_t event);
+    void SendDueReports();
+    void SchedulerLoop();
+
+    HidReportSink& m_inner;
+
+    std::thread m_schedulerThread;
+    std::atomic<bool> m_running{ false };
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wakeCondition;
+    std::condition_variable m_drainedCondition;
+    std::condition_variable m_roomCondition;
+    Clock::time_point m_epoch;
+    uint64_t m_epochEvent = 0;
+    Clock::duration m_interval;
+    size_t m_reportsPerEvent;
+    size_t m_maxBacklogCount;
+    std::array<std::vector<ScheduledReport>, m_wheelSlotCount> m_wheel;
+    std::array<uint64_t, m_reportIdCount> m_lastEventForReport{};
+    std::array<size_t, m_reportIdCount> m_backlogCount{};
+    uint64_t m_nextEvent = 0;
+    // The event the scheduler thread sleeps towards; a report for an earlier one wakes it.
+    uint64_t m_waitingForEvent = UINT64_MAX;
+    bool m_wakeEarly = false;
+    size_t m_pendingCount = 0;
+    bool m_sending = false;
+
+    // Reports taken off the wheel for the current event; scheduler thread only.
+    std::vector<ScheduledReport> m_due;
+
+    std::atomic<uint64_t> m_eventCount{ 0 };
+    std::atomic<uint64_t> m_reportCount{ 0 };
+    std::atomic<uint64_t> m_deferredCount{ 0 };
+    std::atomic<uint64_t> m_blockedCount{ 0 };
+    std::atomic<int64_t> m_blockedNs{ 0 };
+    std::atomic<int64_t> m_jitterSumNs{ 0 };
+    std::atomic<int64_t> m_jitterMaxNs{ 0 };
+};
+
+#endif // REPORT_SCHEDULER_H
@@ -0,0 +1,370 @@
+#include "SharedInputRing.h"
+#include <algorithm>
+#include <new>
+#include <thread>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <climits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#endif
+#endif
+
+struct SharedInputRing::Header
+{
+    std::atomic<uint32_t> magic;        // written last by the creator
+    uint32_t version;
+    uint64_t capacity;
+    alignas(64) std::atomic<uint64_t> enqueuePos;
+    alignas(64) std::atomic<uint64_t> dequeuePos;
+    alignas(64) std::atomic<uint32_t> doorbell;
+    std::atomic<uint32_t> consumerSleeping;
+};
+
+struct alignas(64) SharedInputRing::Cell
+{
+    std::atomic<uint64_t> sequence;
+    InputIpc::WireEvent event;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+    "the ring is shared between processes and needs address-free atomics");
+
+namespace
+{
+    constexpr int m_spinCount = 64;
+
+    uint64_t RoundUpToPowerOfTwo(uint64_t value)
+    {
+        uint64_t result = 2;
+        while (result < value)
+            result <<= 1;
+        return result;
+    }
+
+#if !defined(_WIN32)
+    // The creator holds an exclusive lock on the object until it closes the
+    // ring; the system drops the lock with a process that dies.
+    bool HasLiveOwner(const std::string& name)
+    {
+        int fd = shm_open(name.c_str(), O_RDWR, 0);
+        if (fd < 0)
+            return errno != ENOENT;
+        bool live = flock(fd, LOCK_SH | LOCK_NB) != 0;
+        close(fd);
+        return live;
+    }
+#endif
+
+#if defined(__linux__)
+    // The mapping is shared, so the futex must not be process-private.
+    void FutexWait(std::atomic<uint32_t>& word, uint32_t expected, std::chrono::milliseconds timeout)
+    {
+        timespec relative{};
+        relative.tv_sec = static_cast<time_t>(timeout.count() / 1000);
+        relative.tv_nsec = static_cast<long>(timeout.count() % 1000) * 1000000;
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT, expected, &relative, nullptr, 0);
+    }
+
+    void FutexWakeAll(std::atomic<uint32_t>& word)
+    {
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+    }
+#endif
+}
+
+SharedInputRing::~SharedInputRing()
+{
+    Close();
+}
+
+bool SharedInputRing::Map(const std::string& name, size_t size, bool create)
+{
+#if defined(_WIN32)
+    HANDLE mapping = nullptr;
+    if (create) {
+        mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+            static_cast<DWORD>(static_cast<uint64_t>(size) >> 32), static_cast<DWORD>(size), name.c_str());
+        // Mappings go away with their last handle, so an existing one belongs to a live daemon.
+        if (mapping && GetLastError() == ERROR_ALREADY_EXISTS) {
+            CloseHandle(mapping);
+            return false;
+        }
+    }
+    else {
+        mapping = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, name.c_str());
+    }
+    if (!mapping)
+        return false;
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+    MEMORY_BASIC_INFORMATION region{};
+    if (!view || VirtualQuery(view, &region, sizeof(region)) == 0) {
+        if (view)
+            UnmapViewOfFile(view);
+        CloseHandle(mapping);
+        return false;
+    }
+
+    std::string doorbellName = name + "-Doorbell";
+    HANDLE doorbell = create
+        ? CreateEventA(nullptr, FALSE, FALSE, doorbellName.c_str())
+        : OpenEventA(EVENT_MODIFY_STATE | SYNCHRONIZE, FALSE, doorbellName.c_str());
+    if (!doorbell) {
+        UnmapViewOfFile(view);
+        CloseHandle(mapping);
+        return false;
+    }
+
+    m_mapping = mapping;
+    m_doorbell = doorbell;
+    m_mappedSize = create ? size : region.RegionSize;
+#else
+    int fd = -1;
+    if (create) {
+        fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0 && errno == EEXIST && !HasLiveOwner(name)) {
+            // A daemon that crashed leaves its ring behind; start over.
+            shm_unlink(name.c_str());
+            fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        }
+        if (fd >= 0 && (flock(fd, LOCK_EX | LOCK_NB) != 0 || ftruncate(fd, static_cast<off_t>(size)) != 0)) {
+            close(fd);
+            shm_unlink(name.c_str());
+            return false;
+        }
+    }
+    else {
+        fd = shm_open(name.c_str(), O_RDWR, 0);
+        struct stat status {};
+        if (fd >= 0 && fstat(fd, &status) == 0)
+            size = static_cast<size_t>(status.st_size);
+        else
+            size = 0;
+    }
+    if (fd < 0)
+        return false;
+    if (size < sizeof(Header)) {
+        close(fd);
+        return false;
+    }
+
+    void* view = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (view == MAP_FAILED) {
+        close(fd);
+        if (create)
+            shm_unlink(name.c_str());
+        return false;
+    }
+    // The mapping keeps the object alive; the creator keeps its lock too.
+    if (create)
+        m_ownerFd = fd;
+    else
+        close(fd);
+    m_mappedSize = size;
+#endif
+
+    m_header = static_cast<Header*>(view);
+    m_cells = reinterpret_cast<Cell*>(reinterpret_cast<uint8_t*>(view) + sizeof(Header));
+    m_owner = create;
+    m_name = name;
+    return true;
+}
+
+bool SharedInputRing::Create(const std::string& name, size_t capacity)
+{
+    Close();
+
+    if (capacity > InputIpc::m_maxRingCapacity)
+        return false;
+    uint64_t cellCount = RoundUpToPowerOfTwo(capacity);
+    size_t size = sizeof(Header) + static_cast<size_t>(cellCount) * sizeof(Cell);
+    if (!Map(InputIpc::RingName(name), size, true))
+        return false;
+
+    // Fresh shared memory is zeroed; construct the atomics in place.
+    new (m_header) Header();
+    m_header->version = InputIpc::m_version;
+    m_header->capacity = cellCount;
+    for (uint64_t i = 0; i < cellCount; ++i)
+    {
+        Cell* cell = new (&m_cells[i]) Cell();
+        cell->sequence.store(i, std::memory_order_relaxed);
+    }
+    m_capacity = cellCount;
+    m_mask = cellCount - 1;
+    m_header->magic.store(InputIpc::m_magic, std::memory_order_release);
+    return true;
+}
+
+bool SharedInputRing::Open(const std::string& name)
+{
+    Close();
+
+    if (!Map(InputIpc::RingName(name), 0, false))
+        return false;
+
+    // Also rejects a ring that is still being set up. The header is read
+    // once; only the local copy of the capacity is used from here on.
+    bool ready = m_header->magic.load(std::memory_order_acquire) == InputIpc::m_magic;
+    uint64_t capacity = m_header->capacity;
+    if (!ready || m_header->version != InputIpc::m_version ||
+        capacity < 2 || capacity > InputIpc::m_maxRingCapacity || (capacity & (capacity - 1)) != 0 ||
+        m_mappedSize < sizeof(Header) + static_cast<size_t>(capacity) * sizeof(Cell)) {
+        Close();
+        return false;
+    }
+    m_capacity = capacity;
+    m_mask = capacity - 1;
+    return true;
+}
+
+void SharedInputRing::Close()
+{
+    if (!m_header)
+        return;
+
+#if defined(_WIN32)
+    UnmapViewOfFile(m_header);
+    CloseHandle(static_cast<HANDLE>(m_doorbell));
+    CloseHandle(static_cast<HANDLE>(m_mapping));
+    m_doorbell = nullptr;
+    m_mapping = nullptr;
+#else
+    munmap(m_header, m_mappedSize);
+    if (m_owner)
+        shm_unlink(m_name.c_str());
+    if (m_ownerFd >= 0)
+        close(m_ownerFd);
+    m_ownerFd = -1;
+#endif
+
+    m_header = nullptr;
+    m_cells = nullptr;
+    m_capacity = 0;
+    m_mask = 0;
+    m_mappedSize = 0;
+    m_owner = false;
+    m_name.clear();
+}
+
+bool SharedInputRing::TryPush(const InputIpc::WireEvent& event)
+{
+    uint64_t pos = m_header->enqueuePos.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        Cell& cell = m_cells[pos & m_mask];
+        uint64_t sequence = cell.sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<int64_t>(sequence - pos);
+        if (diff == 0)
+        {
+            if (m_header->enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                cell.event = event;
+                cell.sequence.store(pos + 1, std::memory_order_release);
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            return false; // full
+        }
+        else
+        {
+            pos = m_header->enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    // Pairs with the fence in WaitForEvents(): either the consumer sees this
+    // event before parking, or we see it parked.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_header->consumerSleeping.load(std::memory_order_relaxed) != 0)
+        RingDoorbell();
+    return true;
+}
+
+bool SharedInputRing::TryPop(InputIpc::WireEvent& event)
+{
+    // Single consumer: no other thread moves dequeuePos.
+    uint64_t pos = m_header->dequeuePos.load(std::memory_order_relaxed);
+    Cell& cell = m_cells[pos & m_mask];
+    if (cell.sequence.load(std::memory_order_acquire) != pos + 1)
+        return false; // empty, or the next producer has not finished writing
+
+    event = cell.event;
+    cell.sequence.store(pos + m_capacity, std::memory_order_release);
+    m_header->dequeuePos.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+void SharedInputRing::WaitForEvents(std::chrono::milliseconds timeout)
+{
+    auto hasEvent = [this] {
+        uint64_t pos = m_header->dequeuePos.load(std::memory_order_relaxed);
+        return m_cells[pos & m_mask].sequence.load(std::memory_order_acquire) == pos + 1;
+    };
+
+    // Bursts usually continue within microseconds; stay awake for them.
+    for (int i = 0; i < m_spinCount; ++i)
+    {
+        if (hasEvent())
+            return;
+        std::this_thread::yield();
+    }
+
+    uint32_t ticket = m_header->doorbell.load(std::memory_order_acquire);
+    m_header->consumerSleeping.store(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!hasEvent())
+    {
+#if defined(_WIN32)
+        WaitForSingleObject(static_cast<HANDLE>(m_doorbell), static_cast<DWORD>(timeout.count()));
+#elif defined(__linux__)
+        FutexWait(m_header->doorbell, ticket, timeout);
+#else
+        (void)ticket;
+        std::this_thread::sleep_for(std::min(timeout, std::chrono::milliseconds(1)));
+#endif
+    }
+    m_header->consumerSleeping.store(0, std::memory_order_relaxed);
+}
+
+void SharedInputRing::Wake()
+{
+    RingDoorbell();
+}
+
+void SharedInputRing::RingDoorbell()
+{
+    m_header->doorbell.fetch_add(1, std::memory_order_release);
+#if defined(_WIN32)
+    SetEvent(static_cast<HANDLE>(m_doorbell));
+#elif defined(__linux__)
+    FutexWakeAll(m_header->doorbell);
+#endif
+}
+
+uint64_t SharedInputRing::GetEnqueuePosition() const
+{
+    return m_header->enqueuePos.load(std::memory_order_acquire);
+}
+
+uint64_t SharedInputRing::GetDequeuePosition() const
+{
+    return m_header->dequeuePos.load(std::memory_order_acquire);
+}
+
+size_t SharedInputRing::Capacity() const
+{
+    return static_cast<size_t>(m_capacity);
+}
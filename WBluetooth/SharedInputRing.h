@@ -0,0 +1,80 @@
+#ifndef SHARED_INPUT_RING_H
+#define SHARED_INPUT_RING_H
+
+#include "InputIpc.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Bounded multi-producer/single-consumer ring of wire events in named shared
+// memory, written by any number of client processes and read by the daemon.
+// Same sequence-per-cell scheme as InputQueue, laid out so the atomics are
+// usable from every process that maps it.
+//
+// A consumer that runs dry parks on a doorbell (a futex on Linux, a named
+// event on Windows) and producers only ring it while the consumer sleeps,
+// so a busy stream costs no system calls on either side.
+//
+// Capacity and mask are checked once when mapping and kept locally; a client
+// that scribbles over the header cannot send the other side out of bounds.
+// A producer that dies between claiming a cell and filling it stalls the
+// consumer at that cell for good: nothing can tell it from a slow producer,
+// and skipping the cell would race the late write. The daemon has to be
+// restarted, which creates a new ring.
+class SharedInputRing
+{
+public:
+    SharedInputRing() = default;
+    ~SharedInputRing();
+
+    SharedInputRing(const SharedInputRing&) = delete;
+    SharedInputRing& operator=(const SharedInputRing&) = delete;
+
+    // Daemon side: creates the ring. Fails while another daemon holds a ring
+    // under the same name, and replaces one left behind by a daemon that died.
+    // Capacity is rounded up to a power of two, up to m_maxRingCapacity.
+    bool Create(const std::string& name, size_t capacity = InputIpc::m_defaultRingCapacity);
+    // Client side: maps a ring created by a running daemon.
+    bool Open(const std::string& name);
+    void Close();
+    bool IsOpen() const { return m_header != nullptr; }
+
+    bool TryPush(const InputIpc::WireEvent& event);
+    bool TryPop(InputIpc::WireEvent& event);
+
+    // Consumer only: returns once the ring is not empty or timeout has passed.
+    void WaitForEvents(std::chrono::milliseconds timeout);
+    // Consumer only: makes a pending or later WaitForEvents() return early.
+    void Wake();
+
+    // Positions count every event ever pushed or popped.
+    uint64_t GetEnqueuePosition() const;
+    uint64_t GetDequeuePosition() const;
+    size_t Capacity() const;
+
+private:
+    struct Header;
+    struct Cell;
+
+    bool Map(const std::string& name, size_t size, bool create);
+    void RingDoorbell();
+
+    Header* m_header = nullptr;
+    Cell* m_cells = nullptr;
+    uint64_t m_capacity = 0;
+    uint64_t m_mask = 0;
+    size_t m_mappedSize = 0;
+    bool m_owner = false;
+    std::string m_name;
+#if defined(_WIN32)
+    void* m_mapping = nullptr;
+    void* m_doorbell = nullptr;
+#else
+    // Creator only: kept open, and locked, for as long as the ring is.
+    int m_ownerFd = -1;
+#endif
+};
+
+#endif // SHARED_INPUT_RING_H
@@ -0,0 +1,85 @@
+#include "TextReportCompiler.h"
+
+static KeyboardInputReport MakeReport(uint8_t modifiers, uint8_t usage)
+{
+    KeyboardInputReport report{};
+    report.modifiers = modifiers;
+    report.keys[0] = usage;
+    return report;
+}
+
+TextReportCompiler::Result TextReportCompiler::Compile(const std::u32string& text, const KeyboardLayout& layout)
+{
+    Result result;
+    result.reports.reserve(text.size() + 1);
+
+    uint8_t previousUsage = 0;
+    for (char32_t character : text)
+    {
+        const auto* stroke = layout.Find(character);
+        if (!stroke)
+        {
+            ++result.unmappedCharacters;
+            continue;
+        }
+
+        // The host only sees a new key press if the key was up in between.
+        if (stroke->usage == previousUsage)
+            result.reports.push_back(MakeReport(stroke->modifiers, 0));
+
+        result.reports.push_back(MakeReport(stroke->modifiers, stroke->usage));
+        previousUsage = stroke->usage;
+    }
+
+    if (!result.reports.empty())
+        result.reports.push_back(MakeReport(0, 0));
+    return result;
+}
+
+std::u32string TextReportCompiler::DecodeUtf8(const std::string& utf8)
+{
+    constexpr char32_t replacement = 0xFFFD;
+
+    std::u32string text;
+    text.reserve(utf8.size());
+
+    size_t i = 0;
+    while (i < utf8.size())
+    {
+        auto lead = static_cast<uint8_t>(utf8[i]);
+        size_t length = lead < 0x80 ? 1 : (lead >> 5) == 0x06 ? 2 : (lead >> 4) == 0x0E ? 3 : (lead >> 3) == 0x1E ? 4 : 0;
+        if (length == 0 || i + length > utf8.size())
+        {
+            text.push_back(replacement);
+            ++i;
+            continue;
+        }
+
+        char32_t codePoint = length == 1 ? lead : lead & (0xFF >> (length + 1));
+        bool valid = true;
+        for (size_t k = 1; k < length; ++k)
+        {
+            auto next = static_cast<uint8_t>(utf8[i + k]);
+            if ((next & 0xC0) != 0x80)
+            {
+                valid = false;
+                break;
+            }
+            codePoint = (codePoint << 6) | (next & 0x3F);
+        }
+
+        // Reject overlong forms, surrogates and values beyond Unicode.
+        static constexpr char32_t minimumForLength[] = { 0, 0, 0x80, 0x800, 0x10000 };
+        if (!valid || codePoint < minimumForLength[length] || codePoint > 0x10FFFF ||
+            (codePoint >= 0xD800 && codePoint <= 0xDFFF))
+        {
+            text.push_back(replacement);
+            ++i;
+            continue;
+        }
+
+        text.push_back(codePoint);
+        i += length;
+    }
+    return text;
+}
@@ -0,0 +1,29 @@
+#ifndef TEXT_REPORT_COMPILER_H
+#define TEXT_REPORT_COMPILER_H
+
+#include "HidReports.h"
+#include "KeyboardLayout.h"
+#include <string>
+#include <vector>
+
+// Turns text into the shortest keyboard report sequence that types it.
+//
+// Each character is one report holding its key and modifier bits; moving to
+// the next character replaces the key in the same report, so a release is
+// only inserted when two characters in a row share a key (e.g. "ll", "aA").
+// The sequence always ends with every key released.
+class TextReportCompiler
+{
+public:
+    struct Result {
+        std::vector<KeyboardInputReport> reports;
+        size_t unmappedCharacters = 0;
+    };
+
+    static Result Compile(const std::u32string& text, const KeyboardLayout& layout);
+
+    // Invalid UTF-8 decodes to U+FFFD.
+    static std::u32string DecodeUtf8(const std::string& utf8);
+};
+
+#endif // TEXT_REPORT_COMPILER_H
@@ -0,0 +1,182 @@
+#include "VirtualHidDevice.h"
+#include "EventLog.h"
+
+const char* VirtualHidDevice::StatusToString(GattServiceProviderAdvertisementStatus status)
+{
+    switch (status)
+    {
+    case GattServiceProviderAdvertisementStatus::Created: return "Created";
+    case GattServiceProviderAdvertisementStatus::Stopped: return "Stopped";
+    case GattServiceProviderAdvertisementStatus::Started: return "Started";
+    case GattServiceProviderAdvertisementStatus::Aborted: return "Aborted";
+    default: return "Unknown";
+    }
+}
+
+void VirtualHidDevice::AddReportMap(const uint8_t* collections, size_t size)
+{
+    m_reportMap.insert(m_reportMap.end(), collections, collections + size);
+}
+
+void VirtualHidDevice::AddInputReport(HidReportId reportId)
+{
+    for (auto const& report : m_inputReports)
+    {
+        if (report.reportId == reportId)
+            return;
+    }
+    m_inputReports.push_back({ reportId });
+}
+
+void VirtualHidDevice::InitCharacteristicParameters()
+{
+    m_hidInputReportParameters.CharacteristicProperties(GattCharacteristicProperties::Read | GattCharacteristicProperties::Notify);
+    m_hidInputReportParameters.ReadProtectionLevel(GattProtectionLevel::EncryptionRequired);
+
+    for (auto& report : m_inputReports)
+    {
+        std::vector<uint8_t> reportRef{
+            static_cast<uint8_t>(report.reportId), // Report ID
+            0x01  // Report Type: Input
+        };
+        report.referenceParameters.ReadProtectionLevel(GattProtectionLevel::EncryptionRequired);
+        report.referenceParameters.StaticValue(CryptographicBuffer::CreateFromByteArray(reportRef));
+    }
+
+    m_hidReportMapParameters.CharacteristicProperties(GattCharacteristicProperties::Read);
+    m_hidReportMapParameters.ReadProtectionLevel(GattProtectionLevel::EncryptionRequired);
+    m_hidReportMapParameters.StaticValue(CryptographicBuffer::CreateFromByteArray(m_reportMap));
+
+    std::vector<uint8_t> hidInfo{
+        0x11, 0x01, // HID Version: 1101
+        0x00,       // Country Code: 0
+        0x01        // Not Normally Connectable, Remote Wake supported
+    };
+    m_hidInformationParameters.CharacteristicProperties(GattCharacteristicProperties::Read);
+    m_hidInformationParameters.ReadProtectionLevel(GattProtectionLevel::Plain);
+    m_hidInformationParameters.StaticValue(CryptographicBuffer::CreateFromByteArray(hidInfo));
+
+    m_hidControlPointParameters.CharacteristicProperties(GattCharacteristicProperties::WriteWithoutResponse);
+    m_hidControlPointParameters.WriteProtectionLevel(GattProtectionLevel::Plain);
+}
+
+bool VirtualHidDevice::Initialize()
+{
+    InitCharacteristicParameters();
+    auto op = CreateHidService();
+    op.get();
+    return m_initializationFinished;
+}
+
+IAsyncAction VirtualHidDevice::CreateHidService()
+{
+    // HID service.
+    auto hidServiceProviderCreationResult = co_await GattServiceProvider::CreateAsync(GattServiceUuids::HumanInterfaceDevice());
+    if (hidServiceProviderCreationResult.Error() != BluetoothError::Success)
+        co_return;
+
+    m_hidServiceProvider = hidServiceProviderCreationResult.ServiceProvider();
+    m_hidService = m_hidServiceProvider.Service();
+
+    // One Report characteristic with its Report Reference descriptor per input report.
+    for (auto& report : m_inputReports)
+    {
+        auto reportCharacteristicCreationResult = co_await m_hidService.CreateCharacteristicAsync(GattCharacteristicUuids::Report(), m_hidInputReportParameters);
+        report.characteristic = reportCharacteristicCreationResult.Characteristic();
+        report.characteristic.SubscribedClientsChanged({ this, &VirtualHidDevice::HidReport_SubscribedClientsChanged });
+
+        auto reportReferenceCreationResult = co_await report.characteristic.CreateDescriptorAsync(
+            BluetoothUuidHelper::FromShortId(m_hidReportReferenceDescriptorShortUuid), report.referenceParameters);
+        report.reference = reportReferenceCreationResult.Descriptor();
+    }
+
+    // HID Report Map characteristic.
+    auto hidReportMapCharacteristicCreationResult = co_await m_hidService.CreateCharacteristicAsync(GattCharacteristicUuids::ReportMap(), m_hidReportMapParameters);
+    m_hidReportMap = hidReportMapCharacteristicCreationResult.Characteristic();
+
+    // HID Information characteristic.
+    auto hidInformationCharacteristicCreationResult = co_await m_hidService.CreateCharacteristicAsync(GattCharacteristicUuids::HidInformation(), m_hidInformationParameters);
+    m_hidInformation = hidInformationCharacteristicCreationResult.Characteristic();
+
+    // HID Control Point characteristic.
+    auto hidControlPointCharacteristicCreationResult = co_await m_hidService.CreateCharacteristicAsync(GattCharacteristicUuids::HidControlPoint(), m_hidControlPointParameters);
+    m_hidControlPoint = hidControlPointCharacteristicCreationResult.Characteristic();
+    m_hidControlPoint.WriteRequested({ this, &VirtualHidDevice::HidControlPoint_WriteRequested });
+
+    m_hidServiceProvider.AdvertisementStatusChanged({ this, &VirtualHidDevice::HidServiceProvider_AdvertisementStatusChanged });
+
+    std::scoped_lock lock(m_mutex);
+    m_initializationFinished = true;
+}
+
+GattLocalCharacteristic VirtualHidDevice::Report(HidReportId reportId) const
+{
+    for (auto const& report : m_inputReports)
+    {
+        if (report.reportId == reportId)
+            return report.characteristic;
+    }
+    return nullptr;
+}
+
+void VirtualHidDevice::Enable()
+{
+    PublishService();
+}
+
+void VirtualHidDevice::Disable()
+{
+    UnpublishService();
+}
+
+void VirtualHidDevice::PublishService()
+{
+    GattServiceProviderAdvertisingParameters advParams;
+    advParams.IsConnectable(true);
+    advParams.IsDiscoverable(true);
+    m_hidServiceProvider.StartAdvertising(advParams);
+}
+
+void VirtualHidDevice::UnpublishService()
+{
+    try
+    {
+        auto status = m_hidServiceProvider.AdvertisementStatus();
+        if (status == GattServiceProviderAdvertisementStatus::Started ||
+            status == GattServiceProviderAdvertisementStatus::Aborted)
+        {
+            m_hidServiceProvider.StopAdvertising();
+            if (m_clientChangedHandler)
+                m_clientChangedHandler(nullptr);
+        }
+    }
+    catch (...)
+    {
+        EventLog::Write(LogLevel::Error, "VirtualHidDevice: Failed to stop advertising");
+    }
+}
+
+void VirtualHidDevice::SetSubscribedHidClientsChangedHandler(SubscribedHidClientsChangedHandler handler)
+{
+    m_clientChangedHandler = std::move(handler);
+}
+
+void VirtualHidDevice::HidReport_SubscribedClientsChanged(GattLocalCharacteristic const& sender, IInspectable const&)
+{
+    if (m_clientChangedHandler)
+        m_clientChangedHandler(sender.SubscribedClients());
+}
+
+void VirtualHidDevice::HidControlPoint_WriteRequested(GattLocalCharacteristic const&, GattWriteRequestedEventArgs const& args)
+{
+    auto deferral = args.GetDeferral();
+    auto request = args.GetRequestAsync().get();
+    auto value = request.Value();
+    EventLog::WriteBytes(LogLevel::Info, "VirtualHidDevice Control Point Write:", value.data(), value.Length());
+    deferral.Complete();
+}
+
+void VirtualHidDevice::HidServiceProvider_AdvertisementStatusChanged(GattServiceProvider const&, GattServiceProviderAdvertisementStatusChangedEventArgs const& args)
+{
+    EventLog::WriteText(LogLevel::Info, "VirtualHidDevice Advertisement status:", StatusToString(args.Status()));
+}
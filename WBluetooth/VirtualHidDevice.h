@@ -0,0 +1,97 @@
+#ifndef VIRTUAL_HID_DEVICE_H
+#define VIRTUAL_HID_DEVICE_H
+
+#include "HidReportSink.h"
+#include <winrt/Windows.Devices.Bluetooth.h>
+#include <winrt/Windows.Devices.Bluetooth.GenericAttributeProfile.h>
+#include <winrt/Windows.Storage.Streams.h>
+#include <winrt/Windows.Foundation.Collections.h>
+#include <winrt/Windows.Security.Cryptography.h>
+#include <functional>
+#include <mutex>
+#include <vector>
+#include <string>
+
+using namespace winrt;
+using namespace Windows::Devices::Bluetooth;
+using namespace Windows::Devices::Bluetooth::GenericAttributeProfile;
+using namespace Windows::Storage::Streams;
+using namespace Windows::Foundation;
+using namespace Windows::Foundation::Collections;
+using namespace Windows::Security::Cryptography;
+
+// Composite HID peripheral: one HID service with one report map, one HID
+// Information and one Control Point, shared by every report producer
+// registered on it. The central discovers and subscribes to a single service,
+// and there is one provider to advertise instead of one per device class.
+class VirtualHidDevice
+{
+public:
+    VirtualHidDevice() = default;
+
+private:
+    struct InputReport {
+        HidReportId reportId;
+        GattLocalDescriptorParameters referenceParameters{ GattLocalDescriptorParameters() };
+        GattLocalCharacteristic characteristic{ nullptr };
+        GattLocalDescriptor reference{ nullptr };
+    };
+
+    GattLocalCharacteristicParameters m_hidInputReportParameters{ GattLocalCharacteristicParameters()};
+
+    static constexpr uint16_t m_hidReportReferenceDescriptorShortUuid = 0x2908;
+
+    // HID Report
+    GattLocalCharacteristicParameters m_hidReportMapParameters{ GattLocalCharacteristicParameters()};
+    GattLocalCharacteristicParameters m_hidInformationParameters{ GattLocalCharacteristicParameters()};
+    GattLocalCharacteristicParameters m_hidControlPointParameters{ GattLocalCharacteristicParameters()};
+
+    // BLE GATT Service Structure
+    GattServiceProvider m_hidServiceProvider{ nullptr };
+    GattLocalService m_hidService{ nullptr };
+
+    std::vector<InputReport> m_inputReports;
+    GattLocalCharacteristic m_hidReportMap{ nullptr };
+    GattLocalCharacteristic m_hidInformation{ nullptr };
+    GattLocalCharacteristic m_hidControlPoint{ nullptr };
+
+    // Collections of all registered producers, in registration order.
+    std::vector<uint8_t> m_reportMap;
+
+    // State Variables
+    std::mutex m_mutex;
+    bool m_initializationFinished = false;
+
+    using SubscribedHidClientsChangedHandler = std::function<void(IVectorView<GattSubscribedClient>)>;
+    SubscribedHidClientsChangedHandler m_clientChangedHandler{ nullptr };
+
+    // Utility Functions
+    static const char* StatusToString(GattServiceProviderAdvertisementStatus status);
+
+public:
+    // Producers declare their report map collections and the input reports
+    // those collections carry; call before Initialize().
+    void AddReportMap(const uint8_t* collections, size_t size);
+    void AddInputReport(HidReportId reportId);
+
+    bool Initialize();
+    void Enable();
+    void Disable();
+
+    // Null for report IDs nobody registered.
+    GattLocalCharacteristic Report(HidReportId reportId) const;
+
+    void SetSubscribedHidClientsChangedHandler(SubscribedHidClientsChangedHandler handler);
+
+private:
+    void InitCharacteristicParameters();
+    IAsyncAction CreateHidService();
+    void PublishService();
+    void UnpublishService();
+
+    void HidReport_SubscribedClientsChanged(GattLocalCharacteristic const& sender, IInspectable const& args);
+    void HidControlPoint_WriteRequested(GattLocalCharacteristic const& sender, GattWriteRequestedEventArgs const& args);
+    void HidServiceProvider_AdvertisementStatusChanged(GattServiceProvider const& sender, GattServiceProviderAdvertisementStatusChangedEventArgs const& args);
+};
+
+#endif // VIRTUAL_HID_DEVICE_H
@@ -1,14 +1,8 @@
 #include "VirtualKeyboard.h"
-#include "HidHelper.h"
-#include <sstream>
-#include <iomanip>
-#include <iostream>
-#include <chrono>
-#include <thread>
+#include "HidReportMaps.h"
+#include "EventLog.h"
 
-using namespace std::chrono_literals;
-
-std::string VirtualKeyboard::StatusToString(GattServiceProviderAdvertisementStatus status)
+const char* VirtualKeyboard::StatusToString(GattServiceProviderAdvertisementStatus status)
 {
     switch (status)
     {
@@ -20,24 +14,6 @@ std::string VirtualKeyboard::StatusToString(GattServiceProviderAdvertisementStat
     }
 }
 
-std::string VirtualKeyboard::BufferToString(IBuffer const& buffer)
-{
-    std::vector<uint8_t> data(buffer.Length());
-    DataReader::FromBuffer(buffer).ReadBytes(data);
-    return ByteArrayToString(data);
-}
-
-std::string VirtualKeyboard::ByteArrayToString(const std::vector<uint8_t>& bytes)
-{
-    std::ostringstream oss;
-    for (size_t i = 0; i < bytes.size(); ++i)
-    {
-        if (i > 0) oss << ' ';
-        oss << std::hex << std::uppercase << std::setw(2) << std::setfill('0') << static_cast<int>(bytes[i]);
-    }
-    return oss.str();
-}
-
 void VirtualKeyboard::InitCharacteristicParameters()
 {
 
@@ -62,45 +38,7 @@ void VirtualKeyboard::InitCharacteristicParameters()
     m_hidConsumerReportReferenceParameters.ReadProtectionLevel(GattProtectionLevel::EncryptionRequired);
     m_hidConsumerReportReferenceParameters.StaticValue(CryptographicBuffer::CreateFromByteArray(reportRef2));
 
-    std::vector<uint8_t> reportMap = {
-            0x05, 0x01,        // Usage Page (Generic Desktop Ctrls)
-            0x09, 0x06,        // Usage (Keyboard)
-            0xA1, 0x01,        // Collection (Application)
-            0x85, 0x01,        //   Report ID
-            0x05, 0x07,        //   Usage Page (Kbrd/Keypad)
-            0x19, 0xE0,        //   Usage Minimum (0xE0)
-            0x29, 0xE7,        //   Usage Maximum (0xE7)
-            0x15, 0x00,        //   Logical Minimum (0)
-            0x25, 0x01,        //   Logical Maximum (1)
-            0x95, 0x08,        //   Report Count (8)
-            0x75, 0x01,        //   Report Size (1)
-            0x81, 0x02,        //   Input (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position)
-            0x95, 0x01,        //   Report Count (1)
-            0x75, 0x08,        //   Report Size (8)
-            0x81, 0x01,        //   Input (Const,Array,Abs,No Wrap,Linear,Preferred State,No Null Position)
-            0x05, 0x07,        //   Usage Page (Kbrd/Keypad)
-            0x19, 0x00,        //   Usage Minimum (0x00)
-            0x2a, 0xff, 0x00,  //   Usage Maximum (255)
-            0x15, 0x00,        //   Logical Minimum (0)
-            0x26, 0xff, 0x00,  //   Logical Maximum (255)
-            0x95, 0x06,        //   Report Count (6)
-            0x75, 0x08,        //   Report Size (8)
-            0x81, 0x00,        //   Input (Data,Array,Abs,No Wrap,Linear,Preferred State,No Null Position)
-            0xC0,              // End Collection
-
-            0x05, 0x0C,        // Usage Page (Consumer Devices)
-            0x09, 0x01,        // Usage (Consumer Control)
-            0xA1, 0x01,        // Collection (Application)
-            0x85, 0x02,        //   Report ID = 2
-            0x15, 0x00,        //   Logical Minimum (0)
-            0x26, 0x9C, 0x02,  //   Logical Maximum (0x029C)
-            0x19, 0x00,        //   Usage Minimum (0)
-            0x2A, 0x9C, 0x02,  //   Usage Maximum (0x029C)
-            0x95, 0x01,        //   Report Count (1)
-            0x75, 0x10,        //   Report Size (16)
-            0x81, 0x00,        //   Input (Data,Array,Abs)
-            0xC0               // End Collection
-    };
+    std::vector<uint8_t> reportMap(HidReportMaps::Keyboard.begin(), HidReportMaps::Keyboard.end());
     m_hidReportMapParameters.CharacteristicProperties(GattCharacteristicProperties::Read);
     m_hidReportMapParameters.ReadProtectionLevel(GattProtectionLevel::EncryptionRequired);
     m_hidReportMapParameters.StaticValue(CryptographicBuffer::CreateFromByteArray(reportMap));
@@ -118,9 +56,15 @@ void VirtualKeyboard::InitCharacteristicParameters()
     m_hidControlPointParameters.WriteProtectionLevel(GattProtectionLevel::Plain);
 }
 
+void VirtualKeyboard::RegisterOn(VirtualHidDevice& device)
+{
+    device.AddReportMap(HidReportMaps::Keyboard.begin(), HidReportMaps::Keyboard.size);
+    device.AddInputReport(HidReportId::Keyboard);
+    device.AddInputReport(HidReportId::ConsumerControl);
+}
+
 bool VirtualKeyboard::Initialize()
 {
-    InitFunctionKeyBindings();
     InitCharacteristicParameters();
     auto op = CreateHidService();
     op.get();
@@ -137,45 +81,6 @@ void VirtualKeyboard::Disable()
     UnpublishService();
 }
 
-void VirtualKeyboard::PressKey(uint32_t scanCode)
-{
-    uint8_t usage = HidHelper::GetHidUsageFromPs2Set1(scanCode);
-
-    for (const auto& mapping : m_functionKeyBindings)
-    {
-        if (static_cast<uint8_t>(mapping.key) == usage)
-        {
-            SendConsumerControlKeyAsync(true, mapping.consumerCode).get();
-            return;
-        }
-    }
-
-    ChangeKeyStateAsync(true, usage).get();
-}
-
-void VirtualKeyboard::ReleaseKey(uint32_t scanCode)
-{
-    uint8_t usage = HidHelper::GetHidUsageFromPs2Set1(scanCode);
-
-
-    for (const auto& mapping : m_functionKeyBindings)
-    {
-        if (static_cast<uint8_t>(mapping.key) == usage)
-        {
-            SendConsumerControlKeyAsync(false, mapping.consumerCode).get();
-            return;
-        }
-    }
-
-    ChangeKeyStateAsync(false, usage).get();
-}
-
-void VirtualKeyboard::DirectSendReport(const std::vector<uint8_t>& reportValue)
-{
-    if (reportValue.size() == m_sizeOfKeyboardReportDataInBytes)
-        m_hidKeyboardReport.NotifyValueAsync(CryptographicBuffer::CreateFromByteArray(reportValue)).get();
-}
-
 IAsyncAction VirtualKeyboard::CreateHidService()
 {
     // HID service.
@@ -245,7 +150,7 @@ void VirtualKeyboard::UnpublishService()
         }
     }
     catch (...) {
-        std::cerr << "Failed to stop advertising" << std::endl;
+        EventLog::Write(LogLevel::Error, "VirtualKeyboard: Failed to stop advertising");
     }
 }
 
@@ -254,32 +159,6 @@ void VirtualKeyboard::SetSubscribedHidClientsChangedHandler(SubscribedHidClients
     m_clientChangedHandler = std::move(handler);
 }
 
-void VirtualKeyboard::SetFunctionKeyBinding(FunctionKey key, uint16_t consumerUsage)
-{
-    for (auto& binding : m_functionKeyBindings) {
-        if (binding.key == key) {
-            binding.consumerCode = consumerUsage;
-            return;
-        }
-    }
-
-    m_functionKeyBindings.push_back({ key, consumerUsage});
-}
-
-void VirtualKeyboard::ClearFunctionKeyBinding(FunctionKey key)
-{
-    auto it = std::remove_if(m_functionKeyBindings.begin(), m_functionKeyBindings.end(),
-        [key](const FunctionKeyMapping& mapping) {
-            return mapping.key == key;
-        });
-    m_functionKeyBindings.erase(it, m_functionKeyBindings.end());
-}
-
-void VirtualKeyboard::ClearAllFunctionKeyBindings()
-{
-    m_functionKeyBindings.clear();
-}
-
 void VirtualKeyboard::HidKeyboardReport_SubscribedClientsChanged(GattLocalCharacteristic const& sender, IInspectable const&)
 {
     if (m_clientChangedHandler) 
@@ -290,81 +169,12 @@ void VirtualKeyboard::HidControlPoint_WriteRequested(GattLocalCharacteristic con
 {
     auto deferral = args.GetDeferral();
     auto request = args.GetRequestAsync().get();
-    std::cout << "VirtualKeyboard ControlPoint Write: " << BufferToString(request.Value()) << std::endl;
+    auto value = request.Value();
+    EventLog::WriteBytes(LogLevel::Info, "VirtualKeyboard ControlPoint Write:", value.data(), value.Length());
     deferral.Complete();
 }
 
 void VirtualKeyboard::HidServiceProvider_AdvertisementStatusChanged(GattServiceProvider const&, GattServiceProviderAdvertisementStatusChangedEventArgs const& args)
 {
-    std::cout << "VirtualKeyboard Advertisement status: " << StatusToString(args.Status()) << std::endl;
-}
-
-IAsyncAction VirtualKeyboard::ChangeKeyStateAsync(bool isPress, uint8_t usage)
-{
-    if (!m_initializationFinished || m_hidKeyboardReport.SubscribedClients().Size() == 0)
-        co_return;
-
-    if (isPress)
-    {
-        if (HidHelper::IsModifierKey(usage))
-            m_currentlyDepressedModifierKeys.insert(usage);
-        else
-            m_currentlyDepressedKeys.insert(usage);
-    }
-    else
-    {
-        if (HidHelper::IsModifierKey(usage))
-            m_currentlyDepressedModifierKeys.erase(usage);
-        else
-            m_currentlyDepressedKeys.erase(usage);
-    }
-
-    std::vector<uint8_t> report(m_sizeOfKeyboardReportDataInBytes, 0);
-    for (auto mod : m_currentlyDepressedModifierKeys)
-        report[0] |= HidHelper::GetFlagOfModifierKey(mod);
-
-    size_t idx = 2;
-    for (auto key : m_currentlyDepressedKeys)
-    {
-        if (idx >= report.size())
-            break;
-        report[idx++] = key;
-    }
-
-    m_lastSentKeyboardReportValue = report;
-    co_await m_hidKeyboardReport.NotifyValueAsync(CryptographicBuffer::CreateFromByteArray(report));
-}
-
-IAsyncAction VirtualKeyboard::SendConsumerControlKeyAsync(bool isPress, uint16_t usage)
-{
-    if (!m_initializationFinished || m_hidKeyboardReport.SubscribedClients().Size() == 0)
-        co_return;
-
-    std::vector<uint8_t> report = {
-        0x00, 0x00
-    };
-
-    if (isPress)
-    {
-        report[0] = static_cast<uint8_t>(usage & 0xFF);       // LSB
-        report[1] = static_cast<uint8_t>((usage >> 8) & 0xFF); // MSB
-    }
-
-    co_await m_hidConsumerReport.NotifyValueAsync(CryptographicBuffer::CreateFromByteArray(report));
-}
-
-void VirtualKeyboard::InitFunctionKeyBindings()
-{
-    m_functionKeyBindings = {
-        { FunctionKey::F1,  0x0223 }, // F1 → Home
-        { FunctionKey::F2,  0x0000 }, // F2 → 参考K580键盘，此处应该发送Ctrl(04 00 00 00 00 00 00 00)+Tab(04 2b 00 00 00 00 00 00)(0x2B(Tab 键))
-        { FunctionKey::F3,  0x0224 }, // F3 → Back
-        { FunctionKey::F4,  0x0221 }, // F4 → Search
-        { FunctionKey::F5,  0x00B6 }, // F5 → Previous Track
-        { FunctionKey::F6,  0x00CD }, // F6 → Play/Pause
-        { FunctionKey::F7,  0x00B5 }, // F7 → Next Track
-        { FunctionKey::F8,  0x00E2 }, // F8 → Mute
-        { FunctionKey::F9,  0x00EA }, // F9 → Volume Down
-        { FunctionKey::F10, 0x00E9 }, // F10 → Volume Up
-    };
+    EventLog::WriteText(LogLevel::Info, "VirtualKeyboard Advertisement status:", StatusToString(args.Status()));
 }
\ No newline at end of file
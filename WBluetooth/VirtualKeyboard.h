@@ -1,6 +1,7 @@
 #ifndef VIRTUAL_KEYBOARD_H
 #define VIRTUAL_KEYBOARD_H
 
+#include "VirtualHidDevice.h"
 #include <winrt/Windows.Devices.Bluetooth.h>
 #include <winrt/Windows.Devices.Bluetooth.GenericAttributeProfile.h>
 #include <winrt/Windows.Storage.Streams.h>
@@ -9,7 +10,6 @@
 #include <functional>
 #include <mutex>
 #include <vector>
-#include <unordered_set>
 #include <string>
 
 using namespace winrt;
@@ -22,26 +22,6 @@ using namespace Windows::Security::Cryptography;
 
 class VirtualKeyboard
 {
-    enum class FunctionKey : uint8_t {
-        F1 = 0x3A,
-        F2 = 0x3B,
-        F3 = 0x3C,
-        F4 = 0x3D,
-        F5 = 0x3E,
-        F6 = 0x3F,
-        F7 = 0x40,
-        F8 = 0x41,
-        F9 = 0x42,
-        F10 = 0x43,
-        F11 = 0x44, // not use
-        F12 = 0x45  // not use
-    };
-
-    struct FunctionKeyMapping {
-        FunctionKey key;
-        uint16_t consumerCode;
-    };
-
 public:
     VirtualKeyboard() = default;
 
@@ -62,7 +42,6 @@ private:
     GattLocalCharacteristicParameters m_hidInformationParameters{ GattLocalCharacteristicParameters()};
     GattLocalCharacteristicParameters m_hidControlPointParameters{ GattLocalCharacteristicParameters()};
     //GattLocalCharacteristicParameters m_batteryLevelParameters
-    static constexpr uint32_t m_sizeOfKeyboardReportDataInBytes = 0x8;
 
 	// BLE GATT Service Structure
     GattServiceProvider m_hidServiceProvider{ nullptr };
@@ -82,33 +61,25 @@ private:
     std::mutex m_mutex;
     bool m_initializationFinished = false;
 
-    std::unordered_set<uint8_t> m_currentlyDepressedModifierKeys;
-    std::unordered_set<uint8_t> m_currentlyDepressedKeys;
-    std::vector<uint8_t> m_lastSentKeyboardReportValue = std::vector<uint8_t>(m_sizeOfKeyboardReportDataInBytes);
-
     using SubscribedHidClientsChangedHandler = std::function<void(IVectorView<GattSubscribedClient>)>;
     SubscribedHidClientsChangedHandler m_clientChangedHandler{ nullptr };
 
 	// Utility Functions
-    static std::string StatusToString(GattServiceProviderAdvertisementStatus status);
-    static std::string BufferToString(IBuffer const& buffer);
-    static std::string ByteArrayToString(const std::vector<uint8_t>& bytes);
+    static const char* StatusToString(GattServiceProviderAdvertisementStatus status);
 
 public:
     bool Initialize();
     void Enable();
     void Disable();
 
-    void PressKey(uint32_t ps2Set1ScanCode);
-    void ReleaseKey(uint32_t ps2Set1ScanCode);
-    void DirectSendReport(const std::vector<uint8_t>& reportValue);
+    // Composite mode: declares the keyboard and consumer reports on a shared
+    // HID service instead of creating a service of our own.
+    static void RegisterOn(VirtualHidDevice& device);
 
-    void SetSubscribedHidClientsChangedHandler(SubscribedHidClientsChangedHandler handler);
+    GattLocalCharacteristic KeyboardReport() const { return m_hidKeyboardReport; }
+    GattLocalCharacteristic ConsumerReport() const { return m_hidConsumerReport; }
 
-	// for function keys
-    void SetFunctionKeyBinding(FunctionKey key, uint16_t consumerUsage);
-    void ClearFunctionKeyBinding(FunctionKey key);
-    void ClearAllFunctionKeyBindings();
+    void SetSubscribedHidClientsChangedHandler(SubscribedHidClientsChangedHandler handler);
 
 private:  
     void InitCharacteristicParameters();
@@ -119,12 +90,6 @@ private:
     void HidKeyboardReport_SubscribedClientsChanged(GattLocalCharacteristic const& sender, IInspectable const& args);
     void HidControlPoint_WriteRequested(GattLocalCharacteristic const& sender, GattWriteRequestedEventArgs const& args);
     void HidServiceProvider_AdvertisementStatusChanged(GattServiceProvider const& sender, GattServiceProviderAdvertisementStatusChangedEventArgs const& args);
-
-    IAsyncAction ChangeKeyStateAsync(bool isPress, uint8_t hidUsage);
-    IAsyncAction SendConsumerControlKeyAsync(bool isPress, uint16_t usage);
-
-    void InitFunctionKeyBindings();
-    std::vector<FunctionKeyMapping> m_functionKeyBindings;
 };
 
 #endif // VIRTUAL_KEYBOARD_H
\ No newline at end of file
@@ -1,13 +1,8 @@
 #include "VirtualMouse.h"
-#include <chrono>
-#include <thread>
-#include <iostream>
-#include <sstream>
-#include <iomanip>
+#include "HidReportMaps.h"
+#include "EventLog.h"
 
-using namespace std::chrono_literals;
-
-std::string VirtualMouse::StatusToString(GattServiceProviderAdvertisementStatus status)
+const char* VirtualMouse::StatusToString(GattServiceProviderAdvertisementStatus status)
 {
     switch (status)
     {
@@ -19,26 +14,6 @@ std::string VirtualMouse::StatusToString(GattServiceProviderAdvertisementStatus
     }
 }
 
-std::string VirtualMouse::BufferToString(winrt::Windows::Storage::Streams::IBuffer const& buffer)
-{
-    std::vector<uint8_t> data(buffer.Length());
-    DataReader::FromBuffer(buffer).ReadBytes(data);
-    return ByteArrayToString(data);
-}
-
-std::string VirtualMouse::ByteArrayToString(const std::vector<uint8_t>& bytes)
-{
-    std::ostringstream oss;
-    for (size_t i = 0; i < bytes.size(); ++i)
-    {
-        if (i > 0)
-            oss << ' ';
-        oss << std::hex << std::uppercase << std::setfill('0') << std::setw(2)
-            << static_cast<int>(bytes[i]);
-    }
-    return oss.str();
-}
-
 void VirtualMouse::InitCharacteristicParameters()
 {
     m_hidInputReportParameters.CharacteristicProperties(GattCharacteristicProperties::Read | GattCharacteristicProperties::Notify);
@@ -51,35 +26,20 @@ void VirtualMouse::InitCharacteristicParameters()
     m_hidMouseReportReferenceParameters.ReadProtectionLevel(GattProtectionLevel::EncryptionRequired);
     m_hidMouseReportReferenceParameters.StaticValue(CryptographicBuffer::CreateFromByteArray(mouseReportRef));
 
-    std::vector<uint8_t> reportMap = {
-            0x05, 0x01,        // Usage Page (Generic Desktop Ctrls)
-            0x09, 0x02,        // Usage (Mouse)
-            0xA1, 0x01,        // Collection (Application)
-            0x85, 0x03,        //   Report ID (3)
-            0x09, 0x01,        //   Usage (Pointer)
-            0xA1, 0x00,        //   Collection (Physical)
-            0x05, 0x09,        //     Usage Page (Button)
-            0x19, 0x01,        //     Usage Minimum (0x01)
-            0x29, 0x02,        //     Usage Maximum (0x02)
-            0x15, 0x00,        //     Logical Minimum (0)
-            0x25, 0x01,        //     Logical Maximum (1)
-            0x75, 0x01,        //     Report Size (1)
-            0x95, 0x02,        //     Report Count (2)
-            0x81, 0x02,        //     Input (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position)
-            0x95, 0x06,        //     Report Count (6)
-            0x81, 0x03,        //     Input (Const,Var,Abs,No Wrap,Linear,Preferred State,No Null Position)
-            0x05, 0x01,        //     Usage Page (Generic Desktop Ctrls)
-            0x09, 0x30,        //     Usage (X)
-            0x09, 0x31,        //     Usage (Y)
-            0x09, 0x38,        //     Usage (Wheel)
-            0x15, 0x81,        //     Logical Minimum (-127)
-            0x25, 0x7F,        //     Logical Maximum (127)
-            0x75, 0x08,        //     Report Size (8)
-            0x95, 0x03,        //     Report Count (3)
-            0x81, 0x06,        //     Input (Data,Var,Rel,No Wrap,Linear,Preferred State,No Null Position)
-            0xC0,              //   End Collection
-            0xC0,              // End Collection
-    };
+    std::vector<uint8_t> reportMap = m_highResolutionEnabled
+        ? std::vector<uint8_t>(HidReportMaps::HighResolutionMouse.begin(), HidReportMaps::HighResolutionMouse.end())
+        : std::vector<uint8_t>(HidReportMaps::Mouse.begin(), HidReportMaps::Mouse.end());
+    if (m_absolutePointerEnabled)
+    {
+        std::vector<uint8_t> digitizerReportRef{
+            HidReportMaps::DigitizerReportId, // Report ID: 4
+            0x01  // Report Type: Input
+        };
+        m_hidDigitizerReportReferenceParameters.ReadProtectionLevel(GattProtectionLevel::EncryptionRequired);
+        m_hidDigitizerReportReferenceParameters.StaticValue(CryptographicBuffer::CreateFromByteArray(digitizerReportRef));
+
+        reportMap.insert(reportMap.end(), HidReportMaps::Digitizer.begin(), HidReportMaps::Digitizer.end());
+    }
     m_hidReportMapParameters.CharacteristicProperties(GattCharacteristicProperties::Read);
     m_hidReportMapParameters.ReadProtectionLevel(GattProtectionLevel::EncryptionRequired);
     m_hidReportMapParameters.StaticValue(CryptographicBuffer::CreateFromByteArray(reportMap));
@@ -97,6 +57,20 @@ void VirtualMouse::InitCharacteristicParameters()
     m_hidControlPointParameters.WriteProtectionLevel(GattProtectionLevel::Plain);
 }
 
+void VirtualMouse::RegisterOn(VirtualHidDevice& device, bool absolutePointer, bool highResolution)
+{
+    if (highResolution)
+        device.AddReportMap(HidReportMaps::HighResolutionMouse.begin(), HidReportMaps::HighResolutionMouse.size);
+    else
+        device.AddReportMap(HidReportMaps::Mouse.begin(), HidReportMaps::Mouse.size);
+    device.AddInputReport(HidReportId::Mouse);
+    if (absolutePointer)
+    {
+        device.AddReportMap(HidReportMaps::Digitizer.begin(), HidReportMaps::Digitizer.size);
+        device.AddInputReport(HidReportId::Digitizer);
+    }
+}
+
 bool VirtualMouse::Initialize()
 {
     InitCharacteristicParameters();
@@ -127,6 +101,19 @@ IAsyncAction VirtualMouse::CreateHidService()
         BluetoothUuidHelper::FromShortId(m_hidReportReferenceDescriptorShortUuid), m_hidMouseReportReferenceParameters);
     m_hidMouseReportReference = hidMouseReportReferenceCreationResult.Descriptor();
 
+    if (m_absolutePointerEnabled)
+    {
+        // HID digitizer Report characteristic.
+        auto hidDigitizerReportCharacteristicCreationResult = co_await m_hidService.CreateCharacteristicAsync(GattCharacteristicUuids::Report(), m_hidInputReportParameters);
+        m_hidDigitizerReport = hidDigitizerReportCharacteristicCreationResult.Characteristic();
+        m_hidDigitizerReport.SubscribedClientsChanged({ this, &VirtualMouse::HidMouseReport_SubscribedClientsChanged });
+
+        // HID digitizer Report Reference descriptor.
+        auto hidDigitizerReportReferenceCreationResult = co_await m_hidDigitizerReport.CreateDescriptorAsync(
+            BluetoothUuidHelper::FromShortId(m_hidReportReferenceDescriptorShortUuid), m_hidDigitizerReportReferenceParameters);
+        m_hidDigitizerReportReference = hidDigitizerReportReferenceCreationResult.Descriptor();
+    }
+
     // HID Report Map characteristic.
     auto hidReportMapCharacteristicCreationResult = co_await m_hidService.CreateCharacteristicAsync(GattCharacteristicUuids::ReportMap(), m_hidReportMapParameters);
     m_hidReportMap = hidReportMapCharacteristicCreationResult.Characteristic();
@@ -179,33 +166,10 @@ void VirtualMouse::UnpublishService()
     }
     catch (...)
     {
-        std::cerr << "Failed to stop advertising" << std::endl;
+        EventLog::Write(LogLevel::Error, "VirtualMouse: Failed to stop advertising");
     }
 }
 
-void VirtualMouse::Move(int dx, int dy, int wheel)
-{
-    SendMouseState(m_lastLeftDown, m_lastRightDown, dx, dy, wheel).get();
-    std::this_thread::sleep_for(10ms);
-}
-
-void VirtualMouse::Press()
-{
-    SendMouseState(true, false, 0, 0, 0).get();
-}
-
-void VirtualMouse::Release()
-{
-    SendMouseState(false, false, 0, 0, 0).get();
-}
-
-void VirtualMouse::Click()
-{
-    SendMouseState(true, false, 0, 0, 0).get();
-    std::this_thread::sleep_for(40ms);
-    SendMouseState(false, false, 0, 0, 0).get();
-}
-
 void VirtualMouse::SetSubscribedHidClientsChangedHandler(SubscribedHidClientsChangedHandler handler)
 {
     m_clientChangedHandler = std::move(handler);
@@ -221,28 +185,12 @@ void VirtualMouse::HidControlPoint_WriteRequested(GattLocalCharacteristic const&
 {
     auto deferral = args.GetDeferral();
     auto request = args.GetRequestAsync().get();
-    std::cout << "VirtualMouse Control Point Write: " << BufferToString(request.Value()) << std::endl;
+    auto value = request.Value();
+    EventLog::WriteBytes(LogLevel::Info, "VirtualMouse Control Point Write:", value.data(), value.Length());
     deferral.Complete();
 }
 
 void VirtualMouse::HidServiceProvider_AdvertisementStatusChanged(GattServiceProvider const&, GattServiceProviderAdvertisementStatusChangedEventArgs const& args)
 {
-    std::cout << "VirtualMouse Advertisement status: " << StatusToString(args.Status()) << std::endl;
-}
-
-IAsyncAction VirtualMouse::SendMouseState(bool leftDown, bool rightDown, int mx, int my, int wheel)
-{
-    if (!m_initializationFinished || m_hidMouseReport.SubscribedClients().Size() == 0)
-        co_return;
-
-    std::vector<uint8_t> report(4);
-    report[0] = (leftDown ? 0x01 : 0x00) | (rightDown ? 0x02 : 0x00);
-    report[1] = static_cast<uint8_t>(static_cast<int8_t>(mx));
-    report[2] = static_cast<uint8_t>(static_cast<int8_t>(my));
-    report[3] = static_cast<uint8_t>(static_cast<int8_t>(wheel));
-
-    m_lastLeftDown = leftDown;
-    m_lastRightDown = rightDown;
-
-    co_await m_hidMouseReport.NotifyValueAsync(CryptographicBuffer::CreateFromByteArray(report));
+    EventLog::WriteText(LogLevel::Info, "VirtualMouse Advertisement status:", StatusToString(args.Status()));
 }
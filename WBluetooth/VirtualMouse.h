@@ -1,6 +1,7 @@
 #ifndef VIRTUAL_MOUSE_H
 #define VIRTUAL_MOUSE_H
 
+#include "VirtualHidDevice.h"
 #include <winrt/Windows.Devices.Bluetooth.h>
 #include <winrt/Windows.Devices.Bluetooth.GenericAttributeProfile.h>
 #include <winrt/Windows.Storage.Streams.h>
@@ -29,13 +30,13 @@ private:
 
     static constexpr uint16_t m_hidReportReferenceDescriptorShortUuid = 0x2908;
     GattLocalDescriptorParameters m_hidMouseReportReferenceParameters{ GattLocalDescriptorParameters()};
+    GattLocalDescriptorParameters m_hidDigitizerReportReferenceParameters{ GattLocalDescriptorParameters()};
 
     // HID Report
     GattLocalCharacteristicParameters m_hidReportMapParameters{ GattLocalCharacteristicParameters()};
     GattLocalCharacteristicParameters m_hidInformationParameters{ GattLocalCharacteristicParameters()};
     GattLocalCharacteristicParameters m_hidControlPointParameters{ GattLocalCharacteristicParameters()};
     //GattLocalCharacteristicParameters m_batteryLevelParameters
-    static constexpr uint32_t m_sizeOfMouseReportDataInBytes = 0x4;
 
 	// BLE Gatt Service Structure
     GattServiceProvider m_hidServiceProvider{ nullptr };
@@ -43,6 +44,8 @@ private:
 
     GattLocalCharacteristic m_hidMouseReport{ nullptr };
     GattLocalDescriptor m_hidMouseReportReference{ nullptr };
+    GattLocalCharacteristic m_hidDigitizerReport{ nullptr };
+    GattLocalDescriptor m_hidDigitizerReportReference{ nullptr };
     GattLocalCharacteristic m_hidReportMap{ nullptr };
     GattLocalCharacteristic m_hidInformation{ nullptr };
     GattLocalCharacteristic m_hidControlPoint{ nullptr };
@@ -50,26 +53,31 @@ private:
 	// State Variables
     std::mutex m_mutex;
     bool m_initializationFinished = false;
-    bool m_lastLeftDown = false;
-    bool m_lastRightDown = false;
+    bool m_absolutePointerEnabled = false;
+    bool m_highResolutionEnabled = false;
 
     using SubscribedHidClientsChangedHandler = std::function<void(IVectorView<GattSubscribedClient>)>;
     SubscribedHidClientsChangedHandler m_clientChangedHandler{ nullptr };
 
 	// Utility Functions
-    static std::string StatusToString(GattServiceProviderAdvertisementStatus status);
-    static std::string BufferToString(IBuffer const& buffer);
-    static std::string ByteArrayToString(const std::vector<uint8_t>& bytes);
+    static const char* StatusToString(GattServiceProviderAdvertisementStatus status);
 
 public:
+    // Adds the touch screen collection and its report; call before Initialize().
+    void EnableAbsolutePointer() { m_absolutePointerEnabled = true; }
+    // Serves the high-resolution mouse report map; call before Initialize().
+    void EnableHighResolution() { m_highResolutionEnabled = true; }
     bool Initialize();
     void Enable();
     void Disable();
 
-    void Move(int dx, int dy, int wheel = 0);
-    void Press();
-    void Release();
-    void Click();
+    // Composite mode: declares the mouse report, and the digitizer report if
+    // asked for, on a shared HID service instead of creating a service of our own.
+    static void RegisterOn(VirtualHidDevice& device, bool absolutePointer, bool highResolution);
+
+    GattLocalCharacteristic MouseReport() const { return m_hidMouseReport; }
+    // Null unless EnableAbsolutePointer() was called.
+    GattLocalCharacteristic DigitizerReport() const { return m_hidDigitizerReport; }
 
     void SetSubscribedHidClientsChangedHandler(SubscribedHidClientsChangedHandler handler);
 
@@ -82,8 +90,6 @@ private:
     void HidMouseReport_SubscribedClientsChanged(GattLocalCharacteristic const& sender, IInspectable const& args);
     void HidControlPoint_WriteRequested(GattLocalCharacteristic const& sender, GattWriteRequestedEventArgs const& args);
     void HidServiceProvider_AdvertisementStatusChanged(GattServiceProvider const& sender, GattServiceProviderAdvertisementStatusChangedEventArgs const& args);
-
-    IAsyncAction SendMouseState(bool leftDown, bool rightDown, int mx, int my, int wheel);
 };
 
 